@@ -0,0 +1,788 @@
+#include "Benchmark.hpp"
+#include "Search.hpp"
+#include "MapGen.hpp"
+#include "NeighborMask.hpp"
+#include "BitBfs.hpp"
+#include "MultiBfs.hpp"
+#include "Weights.hpp"
+#include "DeltaStepping.hpp"
+#include "Landmarks.hpp"
+#include "Jps.hpp"
+#include "JpsPlus.hpp"
+#include "ContractionHierarchy.hpp"
+#include "Cpd.hpp"
+#include "GoalBounds.hpp"
+#include "SubgoalGraph.hpp"
+#include "Rsr.hpp"
+#include "QuadTree.hpp"
+#include "NavMesh.hpp"
+#include "ThetaStar.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+static constexpr int QUERIES = 16;
+static constexpr int SIZES[] = { 64, 256, 1024 };
+static constexpr MapFamily FAMILIES[] = { MapFamily::Random, MapFamily::Maze, MapFamily::Rooms, MapFamily::Open };
+
+struct Workload
+{
+    Grid grid;
+    MaskedGrid<Grid> masked;
+    std::vector<std::pair<int, int>> queries;
+};
+
+// Masked neighborhoods read the move masks, the plain ones the walls.
+template<class N> struct UsesMasks : std::false_type {};
+template<class Base, unsigned Bits> struct UsesMasks<MaskedNeighborhood<Base, Bits>> : std::true_type {};
+
+template<class N>
+static const auto& searchGrid(const Workload& w)
+{
+    if constexpr (UsesMasks<N>::value) return w.masked;
+    else return w.grid;
+}
+
+static const Workload& workload(MapFamily family, int size)
+{
+    static std::map<std::pair<int, int>, std::unique_ptr<Workload>> cache;
+    auto& w = cache[{ int(family), size }];
+    if (!w)
+    {
+        w = std::make_unique<Workload>();
+        w->grid = makeMap(family, size, 1234u + unsigned(size));
+        w->masked = MaskedGrid<Grid>(w->grid);
+        w->queries = makeQueries(w->grid, QUERIES, 99u);
+    }
+    return *w;
+}
+
+static std::string mapName(MapFamily family, int size)
+{
+    return std::string(MAP_FAMILY_NAMES[int(family)]) + "/" + std::to_string(size);
+}
+
+// Wide maps in each cell layout: the search is identical, only the slot
+// order of the passability store and the search buffers changes.
+template<class Layout>
+struct LayoutWorkload
+{
+    BasicGrid<Layout> grid;
+    std::vector<std::pair<int, int>> queries;
+};
+
+template<class Layout>
+static const LayoutWorkload<Layout>& wideWorkload(MapFamily family)
+{
+    static std::map<int, std::unique_ptr<LayoutWorkload<Layout>>> cache;
+    auto& w = cache[int(family)];
+    if (!w)
+    {
+        Grid src = makeMap(family, 4096, 1024, 4321u);
+        w = std::make_unique<LayoutWorkload<Layout>>();
+        w->grid = relayout<Layout>(src);
+        for (auto [s, g] : makeQueries(src, 4, 77u))
+            w->queries.emplace_back(w->grid.idx(src.x(s), src.y(s)), w->grid.idx(src.x(g), src.y(g)));
+    }
+    return *w;
+}
+
+template<class Layout, class N>
+static void benchLayout(BenchState& state, MapFamily family)
+{
+    const auto& w = wideWorkload<Layout>(family);
+    FullStorage<int> store;
+    SearchStats stats;
+    ZeroHeuristic h;
+
+    long long expansions = 0;
+    for (auto [s, g] : w.queries)
+    {
+        search<N, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, true>(w.grid, s, g, store, stats, h);
+        expansions += stats.popped - stats.stale;
+    }
+    state.setItems(expansions);
+    state.setBytes(store.bytes() + w.grid.cells.capacity() * sizeof(int));
+
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            search<N, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, false>(w.grid, s, g, store, stats, h);
+}
+
+template<class N, class H>
+struct HeuristicFactory
+{
+    template<class G> static H make(const G&) { return H{}; }
+};
+
+template<class N, class Dist>
+struct HeuristicFactory<N, LandmarkHeuristic<Dist>>
+{
+    template<class G> static LandmarkHeuristic<Dist> make(const G& grid)
+    {
+        std::vector<int> landmarks;
+        for (auto [s, g] : makeQueries(grid, 4, 5u))
+        {
+            landmarks.push_back(s);
+            landmarks.push_back(g);
+        }
+        return makeLandmarkHeuristic<N, Dist>(grid, landmarks);
+    }
+};
+
+// ALT with 8 farthest-point landmarks instead of query endpoints.
+template<class Dist>
+struct FarthestLandmarks : LandmarkHeuristic<Dist> {};
+
+template<class N, class Dist>
+struct HeuristicFactory<N, FarthestLandmarks<Dist>>
+{
+    template<class G> static FarthestLandmarks<Dist> make(const G& grid)
+    {
+        FarthestLandmarks<Dist> h;
+        static_cast<LandmarkHeuristic<Dist>&>(h) = selectLandmarks<N, Dist>(grid, 8);
+        return h;
+    }
+};
+
+// Goal-bounding tables, built once per map and neighborhood and kept for the
+// rest of the run.
+template<class N, class G>
+static const GoalBounds& goalBounds(const G& grid)
+{
+    static std::map<const G*, std::unique_ptr<GoalBounds>> cache;
+    auto& b = cache[&grid];
+    if (!b)
+    {
+        b = std::make_unique<GoalBounds>();
+        b->template build<N>(grid);
+    }
+    return *b;
+}
+
+template<class N, class H>
+struct HeuristicFactory<N, GoalBoundedHeuristic<H>>
+{
+    template<class G> static GoalBoundedHeuristic<H> make(const G& grid)
+    {
+        GoalBoundedHeuristic<H> h;
+        static_cast<H&>(h) = HeuristicFactory<N, H>::make(grid);
+        h.bounds = &goalBounds<N>(grid);
+        return h;
+    }
+};
+
+template<class N, class H, class Queue, class Storage>
+static void benchSearch(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    const auto& grid = searchGrid<N>(w);
+    Storage store;
+    SearchStats stats;
+    H h = HeuristicFactory<N, H>::make(grid);
+
+    long long expansions = 0;
+    std::size_t peakOpen = 0;
+    for (auto [s, g] : w.queries)
+    {
+        search<N, H, Queue, Storage, true>(grid, s, g, store, stats, h);
+        expansions += stats.popped - stats.stale;
+        peakOpen = std::max(peakOpen, stats.peakOpen);
+    }
+    state.setItems(expansions);
+    state.setBytes(store.bytes() + peakOpen * sizeof(typename Queue::Node));
+
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            search<N, H, Queue, Storage, false>(grid, s, g, store, stats, h);
+}
+
+// Full-map floods from each query start: the queue engine with goal -1
+// against the bit-parallel BFS. Items are reached cells.
+static void benchFloodQueue(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    FullStorage<int> store;
+    SearchStats stats;
+    ZeroHeuristic h;
+
+    long long reached = 0;
+    for (auto [s, g] : w.queries)
+    {
+        search<MaskedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, true>(
+            w.masked, s, -1, store, stats, h);
+        reached += stats.popped - stats.stale;
+    }
+    state.setItems(reached);
+    state.setBytes(store.bytes());
+
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            search<MaskedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, false>(
+                w.masked, s, -1, store, stats, h);
+}
+
+static void benchFloodBits(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    BitBfs bfs;
+    bfs.load(w.grid);
+    std::vector<int> dist;
+
+    long long reached = 0;
+    for (auto [s, g] : w.queries)
+        reached += bfs.flood(w.grid, s, dist);
+    state.setItems(reached);
+    state.setBytes(bfs.bytes() + dist.capacity() * sizeof(int));
+
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            bfs.flood(w.grid, s, dist);
+}
+
+// 64 sources over one map: one multi-source sweep against 64 queue floods.
+// Items are (source, reached cell) pairs.
+static std::vector<int> floodSources(const Workload& w)
+{
+    std::vector<int> sources;
+    for (auto [s, g] : makeQueries(w.grid, MultiSourceBfs::BATCH / 2, 31u))
+    {
+        sources.push_back(s);
+        sources.push_back(g);
+    }
+    return sources;
+}
+
+static void benchFieldsQueue(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    std::vector<int> sources = floodSources(w);
+    FullStorage<int> store;
+    SearchStats stats;
+    ZeroHeuristic h;
+
+    long long reached = 0;
+    for (int s : sources)
+    {
+        search<MaskedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, true>(
+            w.masked, s, -1, store, stats, h);
+        reached += stats.popped - stats.stale;
+    }
+    state.setItems(reached);
+    state.setBytes(store.bytes());
+
+    while (state.keepRunning())
+        for (int s : sources)
+            search<MaskedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, false>(
+                w.masked, s, -1, store, stats, h);
+}
+
+static void benchFieldsMulti(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    std::vector<int> sources = floodSources(w);
+    MultiSourceBfs bfs;
+    std::vector<std::vector<int>> fields;
+
+    bfs.fields(w.grid, sources, fields);
+    long long reached = 0;
+    for (const auto& f : fields)
+        for (int d : f) reached += d != INF;
+    state.setItems(reached);
+    state.setBytes(bfs.bytes());
+
+    while (state.keepRunning())
+        bfs.fields(w.grid, sources, fields);
+}
+
+// Point-to-point distances for 64 queries: one Dijkstra per query against
+// the multi-source sweep that stops once every goal is reached.
+static void benchQueriesDijkstra(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    auto pairs = makeQueries(w.grid, MultiSourceBfs::BATCH, 47u);
+    FullStorage<int> store;
+    SearchStats stats;
+    ZeroHeuristic h;
+
+    state.setItems((long long)pairs.size());
+    while (state.keepRunning())
+        for (auto [s, g] : pairs)
+            search<MaskedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, false>(
+                w.masked, s, g, store, stats, h);
+    state.setBytes(store.bytes());
+}
+
+static void benchQueriesMulti(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    auto pairs = makeQueries(w.grid, MultiSourceBfs::BATCH, 47u);
+    MultiSourceBfs bfs;
+    std::vector<int> dist;
+
+    state.setItems((long long)pairs.size());
+    while (state.keepRunning())
+        bfs.queries(w.grid, pairs, dist);
+    state.setBytes(bfs.bytes());
+}
+
+// Point-to-point latency on the query set: A*, online JPS and a contraction
+// hierarchy built once per map (build time is not counted). Items are
+// queries; bytes are the engine's own buffers, the hierarchy included.
+template<class N, class H>
+static void benchLatencyAStar(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    FullStorage<int> store;
+    SearchStats stats;
+    H h;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            search<N, H, RadixHeapQueue<int>, FullStorage<int>, false>(w.masked, s, g, store, stats, h);
+    state.setBytes(store.bytes());
+}
+
+// Same queries over the rectangle-reduced graph; the decomposition is built
+// once per map, outside the timed loop.
+template<class H>
+static void benchLatencyRsr(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    EmptyRectangles rects;
+    rects.build(w.masked);
+    FullStorage<int> store;
+    SearchStats stats;
+    H h;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+        {
+            ReducedGrid<MaskedGrid<Grid>> reduced{ w.masked, rects, g };
+            search<RsrNeighborhood4, H, RadixHeapQueue<int>, FullStorage<int>, false>(reduced, s, g, store, stats, h);
+        }
+    state.setBytes(store.bytes() + rects.bytes());
+}
+
+template<class Jumps, bool Bounded = false>
+static void benchLatencyJps(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    BasicJumpPointSearch<Jumps> jps;
+    if constexpr (std::is_same<Jumps, JumpTable>::value) jps.jumps.build(w.masked);
+    if constexpr (Bounded) jps.bounds = &goalBounds<MaskedNeighborhood8>(w.masked);
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            jps.find(w.masked, s, g, path, stats);
+    state.setBytes(jps.bytes());
+}
+
+template<class N>
+static void benchLatencyCh(BenchState& state, MapFamily family, int size)
+{
+    static std::map<std::pair<int, int>, std::unique_ptr<ContractionHierarchy>> cache;
+    const Workload& w = workload(family, size);
+    auto& ch = cache[{ int(family), size }];
+    if (!ch)
+    {
+        ch = std::make_unique<ContractionHierarchy>();
+        ch->build<N>(w.masked);
+    }
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            ch->find(w.masked, s, g, path, stats);
+    state.setBytes(ch->bytes());
+}
+
+template<class N>
+static void benchLatencySubgoal(BenchState& state, MapFamily family, int size)
+{
+    static std::map<std::pair<int, int>, std::unique_ptr<SubgoalGraph>> cache;
+    const Workload& w = workload(family, size);
+    auto& sg = cache[{ int(family), size }];
+    if (!sg)
+    {
+        sg = std::make_unique<SubgoalGraph>();
+        sg->build<N>(w.masked);
+    }
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            sg->find<N>(w.masked, s, g, path, stats);
+    state.setBytes(sg->bytes());
+}
+
+static void benchLatencyQuadtree(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    QuadTree tree;
+    tree.build(w.masked);
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            tree.find(w.masked, s, g, path, stats);
+    state.setBytes(tree.bytes());
+}
+
+static void benchLatencyNavMesh(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    NavMesh mesh;
+    mesh.build(w.masked);
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            mesh.find(w.masked, s, g, path, stats);
+    state.setBytes(mesh.bytes());
+}
+
+template<class N>
+static void benchLatencyTheta(BenchState& state, MapFamily family, int size)
+{
+    const Workload& w = workload(family, size);
+    ThetaStar theta;
+    theta.build(w.masked);
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            theta.find<N>(w.masked, s, g, path, stats);
+    state.setBytes(theta.bytes());
+}
+
+template<class N>
+static void benchLatencyCpd(BenchState& state, MapFamily family, int size)
+{
+    static std::map<std::pair<int, int>, std::unique_ptr<CompressedPathDatabase>> cache;
+    const Workload& w = workload(family, size);
+    auto& db = cache[{ int(family), size }];
+    if (!db)
+    {
+        db = std::make_unique<CompressedPathDatabase>();
+        db->build<N>(w.masked);
+    }
+    SearchStats stats;
+    std::vector<int> path;
+
+    state.setItems((long long)w.queries.size());
+    while (state.keepRunning())
+        for (auto [s, g] : w.queries)
+            db->find<N>(w.masked, s, g, path, stats);
+    state.setBytes(db->bytes());
+}
+
+// Weighted terrain (entry costs 1-9) over the usual map families.
+struct WeightedWorkload
+{
+    WeightedGrid<Grid> grid;
+    std::vector<int> sources;
+};
+
+static const WeightedWorkload& weightedWorkload(MapFamily family, int size)
+{
+    static std::map<std::pair<int, int>, std::unique_ptr<WeightedWorkload>> cache;
+    auto& w = cache[{ int(family), size }];
+    if (!w)
+    {
+        w = std::make_unique<WeightedWorkload>();
+        w->grid = WeightedGrid<Grid>(makeMap(family, size, 1234u + unsigned(size)));
+        fillTerrain(w->grid, 9, 17u);
+        for (auto [s, g] : makeQueries(w->grid, 2, 23u)) w->sources.push_back(s);
+    }
+    return *w;
+}
+
+static void benchSsspDijkstra(BenchState& state, MapFamily family, int size)
+{
+    const auto& w = weightedWorkload(family, size);
+    FullStorage<int> store;
+    SearchStats stats;
+    ZeroHeuristic h;
+
+    long long reached = 0;
+    for (int s : w.sources)
+    {
+        search<WeightedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, true>(
+            w.grid, s, -1, store, stats, h);
+        reached += stats.popped - stats.stale;
+    }
+    state.setItems(reached);
+    state.setBytes(store.bytes());
+
+    while (state.keepRunning())
+        for (int s : w.sources)
+            search<WeightedNeighborhood4, ZeroHeuristic, RadixHeapQueue<int>, FullStorage<int>, false>(
+                w.grid, s, -1, store, stats, h);
+}
+
+static void benchSsspDelta(BenchState& state, MapFamily family, int size, int threads)
+{
+    const auto& w = weightedWorkload(family, size);
+    DeltaStepping ds;
+    ds.threads = threads;
+    std::vector<int> dist, prev;
+
+    long long reached = 0;
+    for (int s : w.sources)
+    {
+        ds.run<WeightedNeighborhood4>(w.grid, s, dist, prev);
+        for (int d : dist) reached += d != INF;
+    }
+    state.setItems(reached);
+    state.setBytes(ds.bytes() + (dist.capacity() + prev.capacity()) * sizeof(int));
+
+    while (state.keepRunning())
+        for (int s : w.sources)
+            ds.run<WeightedNeighborhood4>(w.grid, s, dist, prev);
+}
+
+// Hold model: n live entries, each op pops the minimum and pushes a key a
+// small random step above it, which is what the Searching loop does.
+template<class Queue>
+static void benchQueue(BenchState& state, int n)
+{
+    const int ops = 1 << 16;
+    std::mt19937 rng(7);
+    std::vector<int> steps(ops);
+    for (int& s : steps) s = 1 + int(rng() % 8);
+
+    state.setItems(n + ops);
+    state.setBytes(std::size_t(n) * sizeof(std::pair<int, int>));
+    while (state.keepRunning())
+    {
+        Queue pq;
+        pq.reset(n);
+        for (int i = 0; i < n; ++i) pq.push(int(rng() % 8), i);
+        for (int i = 0; i < ops; ++i)
+        {
+            auto [d, u] = pq.pop();
+            pq.push(d + steps[i], u);
+        }
+    }
+}
+
+template<class N, class H, class Queue, class Storage>
+static void registerSearch(const std::string& name, std::vector<int> sizes)
+{
+    for (MapFamily family : FAMILIES)
+        for (int size : sizes)
+            registerBenchmark("search/" + name + "/" + mapName(family, size),
+                              [=](BenchState& st) { benchSearch<N, H, Queue, Storage>(st, family, size); });
+}
+
+template<class N, class H, class Dist>
+static void registerQueues(const std::string& name, std::vector<int> sizes)
+{
+    registerSearch<N, H, BinaryHeapQueue<Dist>, FullStorage<Dist>>(name + "/binary", sizes);
+    registerSearch<N, H, DaryHeapQueue<Dist, 4>, FullStorage<Dist>>(name + "/4ary", sizes);
+    registerSearch<N, H, IndexedHeapQueue<Dist, 4>, FullStorage<Dist>>(name + "/indexed4", sizes);
+    registerSearch<N, H, PairingHeapQueue<Dist>, FullStorage<Dist>>(name + "/pairing", sizes);
+    if constexpr (std::is_integral<Dist>::value)
+        registerSearch<N, H, RadixHeapQueue<Dist>, FullStorage<Dist>>(name + "/radix", sizes);
+}
+
+template<class N, class H>
+static void registerDists(const std::string& name)
+{
+    registerQueues<N, H, int>(name + "/int", { 256 });
+    registerQueues<N, H, float>(name + "/float", { 256 });
+}
+
+template<class Layout>
+static void registerLayout(const std::string& name)
+{
+    for (MapFamily family : { MapFamily::Random, MapFamily::Open })
+    {
+        std::string map = std::string(MAP_FAMILY_NAMES[int(family)]) + "/4096x1024";
+        registerBenchmark("layout/" + name + "/n4/" + map,
+                          [=](BenchState& st) { benchLayout<Layout, Neighborhood4>(st, family); });
+        registerBenchmark("layout/" + name + "/n8/" + map,
+                          [=](BenchState& st) { benchLayout<Layout, Neighborhood8>(st, family); });
+    }
+}
+
+template<class Queue>
+static void registerQueueBench(const std::string& name)
+{
+    for (int n : { 64, 4096, 262144 })
+        registerBenchmark("queue/" + name + "/" + std::to_string(n),
+                          [=](BenchState& st) { benchQueue<Queue>(st, n); });
+}
+
+static void registerAll()
+{
+    // Dijkstra over every map size, one entry per queue.
+    registerQueues<Neighborhood4, ZeroHeuristic, int>("n4/zero/int", { SIZES[0], SIZES[1], SIZES[2] });
+
+    // Neighborhood x heuristic x distance type x queue at one size.
+    registerQueues<Neighborhood4, ManhattanHeuristic, int>("n4/manhattan/int", { 256 });
+    registerQueues<Neighborhood4, ManhattanHeuristic, float>("n4/manhattan/float", { 256 });
+    registerDists<Neighborhood4, OctileHeuristic>("n4/octile");
+    registerQueues<Neighborhood4, LandmarkHeuristic<int>, int>("n4/landmark/int", { 256 });
+    registerQueues<Neighborhood4, LandmarkHeuristic<float>, float>("n4/landmark/float", { 256 });
+    registerSearch<MaskedNeighborhood4, ManhattanHeuristic, RadixHeapQueue<int>, FullStorage<int>>(
+        "n4mask/manhattan/int/radix", { SIZES[1], SIZES[2] });
+    registerSearch<MaskedNeighborhood4, FarthestLandmarks<int>, RadixHeapQueue<int>, FullStorage<int>>(
+        "n4mask/alt8/int/radix", { SIZES[1], SIZES[2] });
+    // Goal bounding: one Dijkstra per cell to build, so small maps only.
+    registerSearch<MaskedNeighborhood4, ManhattanHeuristic, RadixHeapQueue<int>, FullStorage<int>>(
+        "n4mask/manhattan/int/radix", { SIZES[0], 128 });
+    registerSearch<MaskedNeighborhood4, GoalBoundedHeuristic<ManhattanHeuristic>, RadixHeapQueue<int>, FullStorage<int>>(
+        "n4mask/manhattan+gb/int/radix", { SIZES[0], 128 });
+    registerSearch<MaskedNeighborhood8, OctileHeuristic, RadixHeapQueue<int>, FullStorage<int>>(
+        "n8mask/octile/int/radix", { SIZES[0], 128 });
+    registerSearch<MaskedNeighborhood8, GoalBoundedHeuristic<OctileHeuristic>, RadixHeapQueue<int>, FullStorage<int>>(
+        "n8mask/octile+gb/int/radix", { SIZES[0], 128 });
+    registerDists<Neighborhood8, ZeroHeuristic>("n8/zero");
+    registerDists<Neighborhood8, OctileHeuristic>("n8/octile");
+    registerQueues<Neighborhood8, LandmarkHeuristic<int>, int>("n8/landmark/int", { 256 });
+    registerQueues<Neighborhood8, LandmarkHeuristic<float>, float>("n8/landmark/float", { 256 });
+
+    // Compact storage: uint16_t only fits maps whose maxSearchKey() < 65535.
+    registerSearch<Neighborhood4, ZeroHeuristic, RadixHeapQueue<std::uint16_t>,
+                   CompactStorage<std::uint16_t, Neighborhood4>>("n4/zero/compact16/radix", { 64 });
+    registerSearch<Neighborhood4, ZeroHeuristic, RadixHeapQueue<std::uint32_t>,
+                   CompactStorage<std::uint32_t, Neighborhood4>>("n4/zero/compact32/radix", { SIZES[0], SIZES[1], SIZES[2] });
+    registerSearch<Neighborhood8, OctileHeuristic, RadixHeapQueue<std::uint32_t>,
+                   CompactStorage<std::uint32_t, Neighborhood8>>("n8/octile/compact32/radix", { 256 });
+
+    // Move masks against bounds and wall checks, same queue and storage.
+    registerQueues<MaskedNeighborhood4, ZeroHeuristic, int>("n4mask/zero/int", { SIZES[0], SIZES[1], SIZES[2] });
+    registerDists<MaskedNeighborhood8, ZeroHeuristic>("n8mask/zero");
+    registerDists<MaskedNeighborhood8, OctileHeuristic>("n8mask/octile");
+
+    for (MapFamily family : FAMILIES)
+        for (int size : SIZES)
+        {
+            registerBenchmark("flood/queue/" + mapName(family, size),
+                              [=](BenchState& st) { benchFloodQueue(st, family, size); });
+            registerBenchmark("flood/bitbfs/" + mapName(family, size),
+                              [=](BenchState& st) { benchFloodBits(st, family, size); });
+        }
+
+    for (MapFamily family : FAMILIES)
+    {
+        for (int size : { SIZES[0], SIZES[1] })
+        {
+            registerBenchmark("fields64/queue/" + mapName(family, size),
+                              [=](BenchState& st) { benchFieldsQueue(st, family, size); });
+            registerBenchmark("fields64/msbfs/" + mapName(family, size),
+                              [=](BenchState& st) { benchFieldsMulti(st, family, size); });
+        }
+        for (int size : { SIZES[1], SIZES[2] })
+        {
+            registerBenchmark("queries64/dijkstra/" + mapName(family, size),
+                              [=](BenchState& st) { benchQueriesDijkstra(st, family, size); });
+            registerBenchmark("queries64/msbfs/" + mapName(family, size),
+                              [=](BenchState& st) { benchQueriesMulti(st, family, size); });
+        }
+    }
+
+    // Open maps are left out of the 8-connected hierarchy: every cell ties
+    // with its neighbours and the build runs for minutes at 256.
+    for (MapFamily family : FAMILIES)
+    {
+        std::string map = mapName(family, SIZES[1]);
+        registerBenchmark("latency/astar/n4/" + map,
+                          [=](BenchState& st) { benchLatencyAStar<MaskedNeighborhood4, ManhattanHeuristic>(st, family, SIZES[1]); });
+        registerBenchmark("latency/astar-rsr/n4/" + map,
+                          [=](BenchState& st) { benchLatencyRsr<ManhattanHeuristic>(st, family, SIZES[1]); });
+        registerBenchmark("latency/quad/n4/" + map,
+                          [=](BenchState& st) { benchLatencyQuadtree(st, family, SIZES[1]); });
+        registerBenchmark("latency/navmesh/n4/" + map,
+                          [=](BenchState& st) { benchLatencyNavMesh(st, family, SIZES[1]); });
+        registerBenchmark("latency/theta/n8/" + map,
+                          [=](BenchState& st) { benchLatencyTheta<MaskedNeighborhood8>(st, family, SIZES[1]); });
+        registerBenchmark("latency/dijkstra/n4/" + map,
+                          [=](BenchState& st) { benchLatencyAStar<MaskedNeighborhood4, ZeroHeuristic>(st, family, SIZES[1]); });
+        registerBenchmark("latency/dijkstra-rsr/n4/" + map,
+                          [=](BenchState& st) { benchLatencyRsr<ZeroHeuristic>(st, family, SIZES[1]); });
+        registerBenchmark("latency/ch/n4/" + map,
+                          [=](BenchState& st) { benchLatencyCh<MaskedNeighborhood4>(st, family, SIZES[1]); });
+        registerBenchmark("latency/astar/n8/" + map,
+                          [=](BenchState& st) { benchLatencyAStar<MaskedNeighborhood8, OctileHeuristic>(st, family, SIZES[1]); });
+        registerBenchmark("latency/jps/n8/" + map,
+                          [=](BenchState& st) { benchLatencyJps<ScanJumps>(st, family, SIZES[1]); });
+        registerBenchmark("latency/jps+/n8/" + map,
+                          [=](BenchState& st) { benchLatencyJps<JumpTable>(st, family, SIZES[1]); });
+        registerBenchmark("latency/ssg/n4/" + map,
+                          [=](BenchState& st) { benchLatencySubgoal<MaskedNeighborhood4>(st, family, SIZES[1]); });
+        registerBenchmark("latency/ssg/n8/" + map,
+                          [=](BenchState& st) { benchLatencySubgoal<MaskedNeighborhood8>(st, family, SIZES[1]); });
+        if (family != MapFamily::Open)
+            registerBenchmark("latency/ch/n8/" + map,
+                              [=](BenchState& st) { benchLatencyCh<MaskedNeighborhood8>(st, family, SIZES[1]); });
+    }
+
+    // The path database and goal bounds do one search per source, so they
+    // run a size down.
+    for (MapFamily family : FAMILIES)
+    {
+        std::string map = mapName(family, 128);
+        registerBenchmark("latency/astar/n4/" + map,
+                          [=](BenchState& st) { benchLatencyAStar<MaskedNeighborhood4, ManhattanHeuristic>(st, family, 128); });
+        registerBenchmark("latency/cpd/n4/" + map,
+                          [=](BenchState& st) { benchLatencyCpd<MaskedNeighborhood4>(st, family, 128); });
+        registerBenchmark("latency/jps+/n8/" + map,
+                          [=](BenchState& st) { benchLatencyJps<JumpTable>(st, family, 128); });
+        registerBenchmark("latency/jps+gb/n8/" + map,
+                          [=](BenchState& st) { benchLatencyJps<JumpTable, true>(st, family, 128); });
+    }
+
+    // Weighted single-source floods: Dijkstra, then delta-stepping from one
+    // thread up to every hardware thread.
+    std::vector<int> threadCounts;
+    for (int t = 1; t < hardwareThreads(); t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(hardwareThreads());
+    for (MapFamily family : FAMILIES)
+        for (int size : { SIZES[2], 4096 })
+        {
+            registerBenchmark("sssp/dijkstra/" + mapName(family, size),
+                              [=](BenchState& st) { benchSsspDijkstra(st, family, size); });
+            for (int t : threadCounts)
+                registerBenchmark("sssp/delta/" + std::to_string(t) + "t/" + mapName(family, size),
+                                  [=](BenchState& st) { benchSsspDelta(st, family, size, t); });
+        }
+
+    registerLayout<RowMajorLayout>("rowmajor");
+    registerLayout<TiledLayout<8>>("tiled8");
+    registerLayout<MortonLayout>("morton");
+
+    registerQueueBench<BinaryHeapQueue<int>>("binary");
+    registerQueueBench<DaryHeapQueue<int, 4>>("4ary");
+    registerQueueBench<IndexedHeapQueue<int, 4>>("indexed4");
+    registerQueueBench<PairingHeapQueue<int>>("pairing");
+    registerQueueBench<RadixHeapQueue<int>>("radix");
+}
+
+int main(int argc, char** argv)
+{
+    registerAll();
+    return runBenchmarks(argc, argv);
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware cache misses via perf_event_open; unavailable elsewhere or when
+// the kernel forbids it, in which case the column reads n/a.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter()
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter()
+    {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    bool available() const { return fd >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long stop()
+    {
+        long long value = 0;
+#ifdef __linux__
+        if (fd < 0) return 0;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) value = 0;
+#endif
+        return value;
+    }
+
+private:
+    int fd = -1;
+};
+
+// Minimal Google-Benchmark-style harness: each benchmark does its setup, then
+// loops on state.keepRunning(). Only the loop is timed (and counted for cache
+// misses); the runner grows the iteration count until it lasts --min-time.
+class BenchState
+{
+public:
+    BenchState(long long iterations, CacheMissCounter& misses)
+        : target(iterations), misses(&misses) {}
+
+    bool keepRunning()
+    {
+        if (done == 0)
+        {
+            misses->start();
+            t0 = std::chrono::steady_clock::now();
+        }
+        if (done == target)
+        {
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            missCount = misses->stop();
+            return false;
+        }
+        ++done;
+        return true;
+    }
+
+    long long iterations() const { return target; }
+
+    // Work items per iteration (expansions, queue operations) and an estimate
+    // of the bytes held, summed from container capacities rather than measured.
+    void setItems(long long n) { items = n; }
+    void setBytes(std::size_t n) { bytes = n; }
+
+    long long items = 0;
+    std::size_t bytes = 0;
+    double seconds = 0.0;
+    long long missCount = 0;
+
+private:
+    long long target, done = 0;
+    CacheMissCounter* misses;
+    std::chrono::steady_clock::time_point t0;
+};
+
+struct Benchmark
+{
+    std::string name;
+    std::function<void(BenchState&)> fn;
+};
+
+inline std::vector<Benchmark>& benchmarks()
+{
+    static std::vector<Benchmark> all;
+    return all;
+}
+
+inline void registerBenchmark(std::string name, std::function<void(BenchState&)> fn)
+{
+    benchmarks().push_back({ std::move(name), std::move(fn) });
+}
+
+inline int runBenchmarks(int argc, char** argv)
+{
+    std::string filter;
+    double minTime = 0.2;
+    for (int a = 1; a < argc; ++a)
+    {
+        if (std::strcmp(argv[a], "--filter") == 0 && a + 1 < argc) filter = argv[++a];
+        else if (std::strcmp(argv[a], "--min-time") == 0 && a + 1 < argc) minTime = std::atof(argv[++a]);
+    }
+
+    CacheMissCounter misses;
+    std::printf("%-44s %14s %10s %12s %14s %12s\n",
+                "Benchmark", "Time/iter", "Iters", "ns/item", "misses/item", "Est. bytes");
+    for (const Benchmark& b : benchmarks())
+    {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+
+        long long n = 1;
+        BenchState last(0, misses);
+        for (;;)
+        {
+            BenchState state(n, misses);
+            b.fn(state);
+            last = state;
+            if (state.seconds >= minTime || n >= (1LL << 30)) break;
+            double grow = state.seconds > 0.0 ? 1.4 * minTime / state.seconds : 10.0;
+            n = std::max(n + 1, (long long)(n * std::min(grow, 10.0)));
+        }
+
+        double perIter = last.seconds * 1e9 / double(n);
+        char itemNs[32] = "-", itemMiss[32] = "n/a", mem[32] = "-";
+        if (last.items > 0)
+            std::snprintf(itemNs, sizeof(itemNs), "%.2f", perIter / double(last.items));
+        if (misses.available() && last.items > 0)
+            std::snprintf(itemMiss, sizeof(itemMiss), "%.3f",
+                          double(last.missCount) / double(n) / double(last.items));
+        if (last.bytes > 0)
+            std::snprintf(mem, sizeof(mem), "%.1f KiB", last.bytes / 1024.0);
+        std::printf("%-44s %11.0f ns %10lld %12s %14s %12s\n",
+                    b.name.c_str(), perIter, n, itemNs, itemMiss, mem);
+        std::fflush(stdout);
+    }
+    return 0;
+}
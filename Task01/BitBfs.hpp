@@ -0,0 +1,112 @@
+#pragma once
+#include "Grid.hpp"
+#include "Bits.hpp"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Bit-parallel BFS for unit-cost 4-connected floods. Each row is packed into
+// 64-bit words (bit b of word w is x = 64w + b). One layer is two shifts, the
+// rows above and below, and an AND with the still-open cells, so 64 cells are
+// expanded per word op. Only words next to a frontier word are touched.
+// Distances equal search<Neighborhood4, ZeroHeuristic, ...> with goal -1.
+class BitBfs
+{
+public:
+    // Packs the floor cells of grid; call again after the grid changes.
+    template<class G>
+    void load(const G& grid)
+    {
+        width = grid.width;
+        height = grid.height;
+        words = (width + 63) / 64;
+        freeBits.assign(std::size_t(words) * height, 0);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                if (grid[grid.idx(x, y)] != 1)
+                    freeBits[std::size_t(y) * words + (x >> 6)] |= std::uint64_t(1) << (x & 63);
+        cur.assign(freeBits.size(), 0);
+        next.assign(freeBits.size(), 0);
+        stamp.assign(freeBits.size(), 0);
+        epoch = 0;
+    }
+
+    // Fills dist (indexed by grid slots, INF where unreachable) from start and
+    // returns the number of cells reached.
+    template<class G>
+    int flood(const G& grid, int start, std::vector<int>& dist)
+    {
+        dist.assign(grid.size(), INF);
+        open = freeBits;
+        int sx = grid.x(start), sy = grid.y(start);
+        int first = sy * words + (sx >> 6);
+        std::uint64_t bit = std::uint64_t(1) << (sx & 63);
+        cur[first] = bit;
+        open[first] &= ~bit;
+        dist[start] = 0;
+        active.assign(1, first);
+
+        int reached = 1;
+        for (int layer = 1; !active.empty(); ++layer)
+        {
+            // Words that can gain cells: each frontier word, the words above and
+            // below it, and a side word only when an edge bit carries into it.
+            candidates.clear();
+            ++epoch;
+            auto consider = [&](int i)
+            {
+                if (stamp[i] != epoch)
+                {
+                    stamp[i] = epoch;
+                    candidates.push_back(i);
+                }
+            };
+            for (int i : active)
+            {
+                int w = i % words;
+                consider(i);
+                if (w > 0 && (cur[i] & 1)) consider(i - 1);
+                if (w + 1 < words && (cur[i] >> 63)) consider(i + 1);
+                if (i >= words) consider(i - words);
+                if (i + words < int(cur.size())) consider(i + words);
+            }
+
+            nextActive.clear();
+            for (int i : candidates)
+            {
+                int w = i % words, y = i / words;
+                std::uint64_t f = cur[i];
+                std::uint64_t v = (f << 1) | (f >> 1);
+                if (w > 0) v |= cur[i - 1] >> 63;
+                if (w + 1 < words) v |= cur[i + 1] << 63;
+                if (y > 0) v |= cur[i - words];
+                if (y + 1 < height) v |= cur[i + words];
+                v &= open[i];
+                if (!v) continue;
+                next[i] = v;
+                open[i] &= ~v;
+                nextActive.push_back(i);
+                for (; v; v &= v - 1)
+                {
+                    dist[grid.idx(w * 64 + lowestBit(v), y)] = layer;
+                    ++reached;
+                }
+            }
+
+            for (int i : active) cur[i] = 0;
+            cur.swap(next);
+            active.swap(nextActive);
+        }
+        return reached;
+    }
+
+    std::size_t bytes() const
+    {
+        return (freeBits.capacity() + open.capacity() + cur.capacity() + next.capacity()) * sizeof(std::uint64_t);
+    }
+
+private:
+    int width = 0, height = 0, words = 0, epoch = 0;
+    std::vector<std::uint64_t> freeBits, open, cur, next;
+    std::vector<int> active, nextActive, candidates, stamp;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest / highest set bit of a non-zero word. 32-bit MSVC has
+// no 64-bit bit scans, so there the word is scanned one half at a time.
+inline int lowestBit(std::uint64_t w)
+{
+#if defined(_MSC_VER) && defined(_M_IX86)
+    unsigned long i;
+    if (_BitScanForward(&i, std::uint32_t(w))) return int(i);
+    _BitScanForward(&i, std::uint32_t(w >> 32));
+    return int(i) + 32;
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, w);
+    return int(i);
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+inline int highestBit(std::uint64_t w)
+{
+#if defined(_MSC_VER) && defined(_M_IX86)
+    unsigned long i;
+    if (_BitScanReverse(&i, std::uint32_t(w >> 32))) return int(i) + 32;
+    _BitScanReverse(&i, std::uint32_t(w));
+    return int(i);
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, w);
+    return int(i);
+#else
+    return 63 - __builtin_clzll(w);
+#endif
+}
@@ -0,0 +1,423 @@
+#pragma once
+#include "Graph.hpp"
+#include "Search.hpp"
+#include "Parallel.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// Contraction hierarchy over the explicit grid graph. Nodes are contracted in
+// rounds: every remaining node whose priority (edge difference plus contracted
+// neighbours) is lowest among its live neighbours is contracted, the whole
+// independent set at once across threads. A shortcut u-x via v is added unless
+// a bounded witness search finds a path u..x of at most the same cost that
+// avoids v. Queries run a bidirectional Dijkstra over upward edges only and
+// unpack shortcuts back into cells.
+//
+// Built for symmetric neighborhoods (Neighborhood4/8 and masked variants):
+// edges are stored undirected, so entry-cost weights are not supported.
+class ContractionHierarchy
+{
+public:
+    int threads = hardwareThreads();
+    int witnessLimit = 256;  // settled nodes per witness search before giving up
+
+    template<class Neighborhood, class G>
+    void build(const G& grid)
+    {
+        GridGraph graph = GridGraph::build<Neighborhood>(grid);
+        int n = graph.nodes();
+        width = grid.width;
+        height = grid.height;
+        slots = grid.size();
+        hash = wallHash(grid);
+        cellOf = graph.cellOf;
+        nodeOf = graph.nodeOf;
+
+        adj.assign(n, {});
+        for (int u = 0; u < n; ++u)
+            for (int e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e)
+                addEdge(u, graph.targets[e], graph.weights[e], -1);
+
+        rank.assign(n, -1);
+        std::vector<int> priority(n, 0), deleted(n, 0), level(n, 0), remaining(n);
+        std::vector<char> dirty(n, 1);
+        for (int v = 0; v < n; ++v) remaining[v] = v;
+        std::vector<Witness> witness(std::max(1, threads));
+        for (auto& w : witness)
+        {
+            w.dist.assign(n, INF);
+            w.target.assign(n, 0);
+        }
+        std::vector<std::vector<Edge>> shortcuts(n);
+
+        int nextRank = 0;
+        while (!remaining.empty())
+        {
+            parallelForThreads(int(remaining.size()), [&](int i, int t)
+            {
+                int v = remaining[i];
+                if (!dirty[v]) return;
+                priority[v] = contract(v, witness[t], nullptr) - int(adj[v].size()) + 2 * deleted[v] + level[v];
+                dirty[v] = 0;
+            });
+
+            std::vector<int> batch;
+            for (int v : remaining)
+            {
+                bool best = true;
+                for (const Edge& e : adj[v])
+                    if (priority[e.to] < priority[v] || (priority[e.to] == priority[v] && e.to < v))
+                    {
+                        best = false;
+                        break;
+                    }
+                if (best) batch.push_back(v);
+            }
+
+            // Ranked first so witness searches skip the whole batch: two
+            // batch nodes must not serve as each other's witness.
+            for (int v : batch) rank[v] = nextRank++;
+            parallelForThreads(int(batch.size()), [&](int i, int t)
+            {
+                int v = batch[i];
+                shortcuts[v].clear();
+                contract(v, witness[t], &shortcuts[v]);
+            });
+
+            for (int v : batch)
+            {
+                for (const Edge& s : shortcuts[v])
+                {
+                    addEdge(s.to, s.mid, s.weight, v);
+                    addEdge(s.mid, s.to, s.weight, v);
+                    ++shortcutCount;
+                }
+                std::vector<Edge>().swap(shortcuts[v]);
+                // adj[v] now holds exactly v's upward edges; the neighbours
+                // drop their edge back to v so later searches skip it.
+                for (const Edge& e : adj[v])
+                {
+                    auto& back = adj[e.to];
+                    back.erase(std::find_if(back.begin(), back.end(), [v](const Edge& b) { return b.to == v; }));
+                    ++deleted[e.to];
+                    level[e.to] = std::max(level[e.to], level[v] + 1);
+                    dirty[e.to] = 1;
+                }
+            }
+            remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                           [&](int v) { return rank[v] >= 0; }),
+                            remaining.end());
+        }
+
+        upOffsets.assign(1, 0);
+        up.clear();
+        for (int v = 0; v < n; ++v)
+        {
+            up.insert(up.end(), adj[v].begin(), adj[v].end());
+            upOffsets.push_back(int(up.size()));
+        }
+        std::vector<std::vector<Edge>>().swap(adj);
+        prepareQuery();
+    }
+
+    // Cell path from startIdx to goalIdx; stats count the nodes settled by
+    // both directions.
+    template<bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        path.clear();
+        lastCost = -1;
+        int s = nodeOf[startIdx], t = nodeOf[goalIdx];
+        if (s < 0 || t < 0) { rec.finish(); return false; }
+
+        for (int side = 0; side < 2; ++side)
+        {
+            for (int v : touched[side]) dist[side][v] = INF;
+            touched[side].clear();
+            queue[side].reset(nodes());
+        }
+        dist[0][s] = 0;
+        dist[1][t] = 0;
+        parent[0][s] = parent[1][t] = -1;
+        touched[0].push_back(s);
+        touched[1].push_back(t);
+        queue[0].push(0, s);
+        queue[1].push(0, t);
+        rec.push(2);
+
+        int best = INF, meet = -1;
+        while (!queue[0].empty() || !queue[1].empty())
+        {
+            int side = queue[1].empty() || (!queue[0].empty() && queue[0].top().first <= queue[1].top().first) ? 0 : 1;
+            if (queue[side].top().first >= best) break;
+            auto [d, u] = queue[side].pop();
+            rec.pop();
+            if (d > dist[side][u]) { rec.stale(); continue; }
+            if (dist[1 - side][u] != INF && d + dist[1 - side][u] < best)
+            {
+                best = d + dist[1 - side][u];
+                meet = u;
+            }
+            for (int e = upOffsets[u]; e < upOffsets[u + 1]; ++e)
+            {
+                int v = up[e].to, nd = d + up[e].weight;
+                if (nd < dist[side][v])
+                {
+                    if (dist[side][v] == INF) touched[side].push_back(v);
+                    dist[side][v] = nd;
+                    parent[side][v] = u;
+                    queue[side].push(nd, v);
+                    rec.relax();
+                    rec.push(queue[0].size() + queue[1].size());
+                }
+            }
+        }
+        rec.finish();
+        if (meet < 0) return false;
+
+        lastCost = best;
+        std::vector<int> nodesUp;
+        for (int v = meet; v >= 0; v = parent[0][v]) nodesUp.push_back(v);
+        std::reverse(nodesUp.begin(), nodesUp.end());
+        for (int v = parent[1][meet]; v >= 0; v = parent[1][v]) nodesUp.push_back(v);
+
+        path.push_back(cellOf[nodesUp[0]]);
+        for (std::size_t i = 1; i < nodesUp.size(); ++i)
+            unpack(nodesUp[i - 1], nodesUp[i], path);
+        (void)grid;
+        return true;
+    }
+
+    long long cost() const { return lastCost; }
+    int nodes() const { return int(cellOf.size()); }
+    int shortcuts() const { return shortcutCount; }
+    int upwardEdges() const { return int(up.size()); }
+    bool empty() const { return cellOf.empty(); }
+    bool matches(int w, int h, int n) const { return width == w && height == h && slots == n; }
+
+    std::size_t bytes() const
+    {
+        return (cellOf.capacity() + nodeOf.capacity() + rank.capacity() + upOffsets.capacity()) * sizeof(int) +
+               up.capacity() * sizeof(Edge);
+    }
+
+    // Binary file: "CH02", width, height, slots, nodes, upward edge count and
+    // a hash of the walls as int32, then cellOf, rank, upOffsets and the
+    // upward edges.
+    bool save(const std::string& file) const
+    {
+        std::ofstream out(file, std::ios::binary);
+        if (!out) return false;
+        std::int32_t header[6] = { width, height, slots, nodes(), upwardEdges(), std::int32_t(hash) };
+        out.write("CH02", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        writeVector(out, cellOf);
+        writeVector(out, rank);
+        writeVector(out, upOffsets);
+        writeVector(out, up);
+        return bool(out);
+    }
+
+    // Fails, leaving the hierarchy untouched, on a missing or truncated file
+    // or one written for other walls.
+    template<class G>
+    bool load(const G& grid, const std::string& file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        char magic[4];
+        std::int32_t header[6];
+        if (!in.read(magic, 4) || std::memcmp(magic, "CH02", 4) != 0) return false;
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+        if (header[0] != grid.width || header[1] != grid.height || header[2] != grid.size() ||
+            header[3] < 0 || header[4] < 0 || std::uint32_t(header[5]) != wallHash(grid))
+            return false;
+
+        ContractionHierarchy ch;
+        ch.width = header[0];
+        ch.height = header[1];
+        ch.slots = header[2];
+        ch.hash = std::uint32_t(header[5]);
+        ch.cellOf.resize(header[3]);
+        ch.rank.resize(header[3]);
+        ch.upOffsets.resize(std::size_t(header[3]) + 1);
+        ch.up.resize(header[4]);
+        readVector(in, ch.cellOf);
+        readVector(in, ch.rank);
+        readVector(in, ch.upOffsets);
+        readVector(in, ch.up);
+        if (!in) return false;
+        ch.nodeOf.assign(ch.slots, -1);
+        for (int v = 0; v < ch.nodes(); ++v)
+        {
+            if (ch.cellOf[v] < 0 || ch.cellOf[v] >= ch.slots) return false;
+            ch.nodeOf[ch.cellOf[v]] = v;
+        }
+        ch.threads = threads;
+        ch.witnessLimit = witnessLimit;
+        *this = std::move(ch);
+        prepareQuery();
+        return true;
+    }
+
+private:
+    struct Edge
+    {
+        int to, weight, mid;  // mid: contracted node a shortcut bypasses, -1 for grid edges
+    };
+
+    struct Witness
+    {
+        std::vector<int> dist, touched;
+        std::vector<char> target;
+        BinaryHeapQueue<int> queue;
+    };
+
+    void addEdge(int u, int v, int weight, int mid)
+    {
+        for (Edge& e : adj[u])
+            if (e.to == v)
+            {
+                if (weight < e.weight) e = { v, weight, mid };
+                return;
+            }
+        adj[u].push_back({ v, weight, mid });
+    }
+
+    // Shortcuts needed to contract v; appended to out (as {u, weight, x} for
+    // a shortcut u-x) when out is set. Returns their number.
+    int contract(int v, Witness& w, std::vector<Edge>* out) const
+    {
+        int added = 0;
+        const auto& edges = adj[v];
+        for (std::size_t i = 0; i < edges.size(); ++i)
+        {
+            const Edge& a = edges[i];
+            int limit = 0;
+            for (std::size_t j = i + 1; j < edges.size(); ++j) limit = std::max(limit, a.weight + edges[j].weight);
+            if (limit == 0) continue;
+
+            for (std::size_t j = i + 1; j < edges.size(); ++j) w.target[edges[j].to] = 1;
+            witnessSearch(a.to, v, limit, int(edges.size() - i - 1), w);
+            for (std::size_t j = i + 1; j < edges.size(); ++j) w.target[edges[j].to] = 0;
+            for (std::size_t j = i + 1; j < edges.size(); ++j)
+            {
+                const Edge& b = edges[j];
+                int via = a.weight + b.weight;
+                if (w.dist[b.to] <= via) continue;
+                ++added;
+                if (out) out->push_back({ a.to, via, b.to });
+            }
+        }
+        return added;
+    }
+
+    // Dijkstra from `from` avoiding `avoid`, until every target is settled,
+    // distances pass limit or witnessLimit nodes are settled.
+    void witnessSearch(int from, int avoid, int limit, int targets, Witness& w) const
+    {
+        for (int u : w.touched) w.dist[u] = INF;
+        w.touched.clear();
+        w.queue.reset(0);
+        w.dist[from] = 0;
+        w.touched.push_back(from);
+        w.queue.push(0, from);
+        int settled = 0;
+        while (!w.queue.empty() && settled < witnessLimit)
+        {
+            auto [d, u] = w.queue.pop();
+            if (d > w.dist[u]) continue;
+            if (d > limit) break;
+            ++settled;
+            if (w.target[u] && --targets == 0) break;
+            for (const Edge& e : adj[u])
+            {
+                if (e.to == avoid || rank[e.to] >= 0) continue;
+                int nd = d + e.weight;
+                if (nd < w.dist[e.to] && nd <= limit)
+                {
+                    if (w.dist[e.to] == INF) w.touched.push_back(e.to);
+                    w.dist[e.to] = nd;
+                    w.queue.push(nd, e.to);
+                }
+            }
+        }
+    }
+
+    template<class F>
+    void parallelForThreads(int count, F&& fn)
+    {
+        std::atomic<int> next{ 0 };
+        runThreads(std::max(1, std::min(threads, count)), [&](int t)
+        {
+            const int chunk = 64;
+            for (int begin; (begin = next.fetch_add(chunk)) < count;)
+                for (int i = begin; i < std::min(begin + chunk, count); ++i) fn(i, t);
+        });
+    }
+
+    // Appends the cells after a up to and including b, expanding shortcuts.
+    void unpack(int a, int b, std::vector<int>& path) const
+    {
+        std::vector<std::pair<int, int>> stack{ { a, b } };
+        while (!stack.empty())
+        {
+            auto [from, to] = stack.back();
+            stack.pop_back();
+            const Edge& e = edgeBetween(from, to);
+            if (e.mid < 0)
+            {
+                path.push_back(cellOf[to]);
+                continue;
+            }
+            stack.push_back({ e.mid, to });
+            stack.push_back({ from, e.mid });
+        }
+    }
+
+    const Edge& edgeBetween(int a, int b) const
+    {
+        int low = rank[a] < rank[b] ? a : b, high = low == a ? b : a;
+        const Edge* found = nullptr;
+        for (int e = upOffsets[low]; e < upOffsets[low + 1]; ++e)
+            if (up[e].to == high) found = &up[e];
+        return *found;
+    }
+
+    void prepareQuery()
+    {
+        for (int side = 0; side < 2; ++side)
+        {
+            dist[side].assign(nodes(), INF);
+            parent[side].assign(nodes(), -1);
+            touched[side].clear();
+        }
+    }
+
+    template<class T>
+    static void writeVector(std::ofstream& out, const std::vector<T>& v)
+    {
+        out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    template<class T>
+    static void readVector(std::ifstream& in, std::vector<T>& v)
+    {
+        in.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    int width = 0, height = 0, slots = 0;
+    std::uint32_t hash = 0;  // wallHash() of the grid built for
+    std::vector<int> cellOf, nodeOf, rank, upOffsets;
+    std::vector<Edge> up;
+    std::vector<std::vector<Edge>> adj;  // only while building
+    int shortcutCount = 0;
+
+    std::vector<int> dist[2], parent[2], touched[2];
+    BinaryHeapQueue<int> queue[2];
+    long long lastCost = -1;
+};
@@ -0,0 +1,267 @@
+#pragma once
+#include "Search.hpp"
+#include "Parallel.hpp"
+#include "FirstMoves.hpp"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// Compressed path database: for every source cell, the first move of a
+// shortest path to every other cell, run-length encoded over the floor cells
+// in Morton order (neighbouring cells mostly share a first move, so runs are
+// long). A query looks up the first move towards the goal, takes it, and
+// repeats from the next cell; no search at all.
+//
+// Each source is one Dijkstra that carries the set of optimal first moves per
+// cell; compression then picks, per run, a move common to as many
+// consecutive cells as possible. Sources are built in parallel.
+class CompressedPathDatabase
+{
+public:
+    int threads = hardwareThreads();
+
+    template<class Neighborhood, class G>
+    void build(const G& grid)
+    {
+        static_assert(Neighborhood::COUNT <= 8, "first moves are stored in 3 bits");
+        width = grid.width;
+        height = grid.height;
+        slots = grid.size();
+        moves = Neighborhood::COUNT;
+        hash = wallHash(grid);
+
+        MortonLayout morton(width, height);
+        cellOf.clear();
+        for (int v = 0; v < slots; ++v)
+            if (grid[v] != 1) cellOf.push_back(v);
+        std::sort(cellOf.begin(), cellOf.end(), [&](int a, int b)
+        {
+            return morton.idx(grid.x(a), grid.y(a)) < morton.idx(grid.x(b), grid.y(b));
+        });
+        indexCells();
+        labelComponents<Neighborhood>(grid);
+        int n = nodes();
+
+        std::vector<std::vector<std::uint32_t>> perSource(n);
+        std::vector<Scratch> scratch(std::max(1, threads));
+        std::atomic<int> next{ 0 };
+        runThreads(std::max(1, std::min(threads, n)), [&](int t)
+        {
+            for (int s; (s = next.fetch_add(1)) < n;)
+                perSource[s] = compress(firstMoves<Neighborhood>(grid, cellOf[s], scratch[t]));
+        });
+
+        offsets.assign(1, 0);
+        runs.clear();
+        for (auto& r : perSource)
+        {
+            runs.insert(runs.end(), r.begin(), r.end());
+            offsets.push_back(std::uint32_t(runs.size()));
+            std::vector<std::uint32_t>().swap(r);
+        }
+    }
+
+    // Walks first moves from startIdx to goalIdx; stats count the steps as
+    // pops. Cells in another component, or walls, give no path.
+    template<class Neighborhood, bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        path.clear();
+        lastCost = -1;
+        int s = nodeOf[startIdx], g = nodeOf[goalIdx];
+        if (s < 0 || g < 0 || component[s] != component[g]) { rec.finish(); return false; }
+
+        // A move table that does not fit the grid could lead off the floor
+        // or round in circles; give up rather than follow it.
+        long long total = 0;
+        path.push_back(startIdx);
+        for (int u = s, steps = 0; u != g; ++steps)
+        {
+            if (u < 0 || steps >= nodes()) { rec.finish(); path.clear(); return false; }
+            int k = firstMove(u, g);
+            int cell = cellOf[u];
+            int v = grid.step(cell, Neighborhood::DX[k], Neighborhood::DY[k]);
+            total += Neighborhood::template cost<int>(grid, v, k);
+            path.push_back(v);
+            u = nodeOf[v];
+            rec.pop();
+        }
+        rec.finish();
+        lastCost = total;
+        return true;
+    }
+
+    long long cost() const { return lastCost; }
+    int nodes() const { return int(cellOf.size()); }
+    std::size_t runCount() const { return runs.size(); }
+    bool empty() const { return cellOf.empty(); }
+    bool matches(int w, int h, int n) const { return width == w && height == h && slots == n; }
+
+    std::size_t bytes() const
+    {
+        return (cellOf.capacity() + nodeOf.capacity() + component.capacity()) * sizeof(int) +
+               (offsets.capacity() + runs.capacity()) * sizeof(std::uint32_t);
+    }
+
+    // Binary file: "CPD2", width, height, slots, moves, nodes, run count and
+    // a hash of the walls as int32, then cellOf, component, offsets and runs.
+    bool save(const std::string& file) const
+    {
+        std::ofstream out(file, std::ios::binary);
+        if (!out) return false;
+        std::int32_t header[7] = { width, height, slots, moves, nodes(), std::int32_t(runs.size()), std::int32_t(hash) };
+        out.write("CPD2", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        writeVector(out, cellOf);
+        writeVector(out, component);
+        writeVector(out, offsets);
+        writeVector(out, runs);
+        return bool(out);
+    }
+
+    // Fails, leaving the database untouched, on a missing or truncated file
+    // or one written for another grid shape, neighborhood or walls.
+    template<class Neighborhood, class G>
+    bool load(const G& grid, const std::string& file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        char magic[4];
+        std::int32_t header[7];
+        if (!in.read(magic, 4) || std::memcmp(magic, "CPD2", 4) != 0) return false;
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+        if (header[0] != grid.width || header[1] != grid.height || header[2] != grid.size() ||
+            header[3] != Neighborhood::COUNT || header[4] < 0 || header[5] < 0 ||
+            std::uint32_t(header[6]) != wallHash(grid))
+            return false;
+
+        CompressedPathDatabase db;
+        db.width = header[0];
+        db.height = header[1];
+        db.slots = header[2];
+        db.moves = header[3];
+        db.hash = std::uint32_t(header[6]);
+        db.cellOf.resize(header[4]);
+        db.component.resize(header[4]);
+        db.offsets.resize(std::size_t(header[4]) + 1);
+        db.runs.resize(header[5]);
+        readVector(in, db.cellOf);
+        readVector(in, db.component);
+        readVector(in, db.offsets);
+        readVector(in, db.runs);
+        if (!in) return false;
+        for (int c : db.cellOf)
+            if (c < 0 || c >= db.slots) return false;
+        db.indexCells();
+        db.threads = threads;
+        *this = std::move(db);
+        return true;
+    }
+
+private:
+    static constexpr std::uint8_t ANY = 0xFF;  // source and unreachable cells: any move will do
+
+    struct Scratch
+    {
+        FirstMoveSearch search;
+        std::vector<std::uint8_t> masks;  // per node, in Morton order
+    };
+
+    // Run = (first node index << 3) | move; the runs of one source are sorted
+    // by node index and the last one at or before the goal holds its move.
+    int firstMove(int u, int g) const
+    {
+        const std::uint32_t* begin = runs.data() + offsets[u];
+        const std::uint32_t* end = runs.data() + offsets[u + 1];
+        const std::uint32_t* it = std::upper_bound(begin, end, (std::uint32_t(g) << 3) | 7u);
+        return int(it[-1] & 7u);
+    }
+
+    template<class Neighborhood, class G>
+    std::vector<std::uint8_t>& firstMoves(const G& grid, int start, Scratch& s) const
+    {
+        s.search.run<Neighborhood>(grid, start);
+        s.masks.resize(nodes());
+        for (int i = 0; i < nodes(); ++i)
+        {
+            int c = cellOf[i];
+            s.masks[i] = c == start || s.search.dist[c] == INF ? ANY : s.search.first[c];
+        }
+        return s.masks;
+    }
+
+    // Greedy runs: extend while some move is optimal for every cell so far.
+    static std::vector<std::uint32_t> compress(const std::vector<std::uint8_t>& masks)
+    {
+        std::vector<std::uint32_t> out;
+        std::uint8_t common = ANY;
+        std::uint32_t begin = 0;
+        for (std::uint32_t i = 0; i < masks.size(); ++i)
+        {
+            if (common & masks[i])
+            {
+                common &= masks[i];
+                continue;
+            }
+            out.push_back((begin << 3) | std::uint32_t(lowestBit(common)));
+            common = masks[i];
+            begin = i;
+        }
+        out.push_back((begin << 3) | std::uint32_t(lowestBit(common)));
+        return out;
+    }
+
+    void indexCells()
+    {
+        nodeOf.assign(slots, -1);
+        for (int i = 0; i < nodes(); ++i) nodeOf[cellOf[i]] = i;
+    }
+
+    template<class Neighborhood, class G>
+    void labelComponents(const G& grid)
+    {
+        component.assign(nodes(), -1);
+        std::vector<int> stack;
+        for (int i = 0, next = 0; i < nodes(); ++i)
+        {
+            if (component[i] >= 0) continue;
+            component[i] = next;
+            stack.push_back(i);
+            while (!stack.empty())
+            {
+                int u = stack.back();
+                stack.pop_back();
+                Neighborhood::forEach(grid, cellOf[u], [&](int v, int)
+                {
+                    if (component[nodeOf[v]] < 0)
+                    {
+                        component[nodeOf[v]] = next;
+                        stack.push_back(nodeOf[v]);
+                    }
+                });
+            }
+            ++next;
+        }
+    }
+
+    template<class T>
+    static void writeVector(std::ofstream& out, const std::vector<T>& v)
+    {
+        out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    template<class T>
+    static void readVector(std::ifstream& in, std::vector<T>& v)
+    {
+        in.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(T));
+    }
+
+    int width = 0, height = 0, slots = 0, moves = 0;
+    std::uint32_t hash = 0;  // wallHash() of the grid built for
+    std::vector<int> cellOf, nodeOf, component;
+    std::vector<std::uint32_t> offsets, runs;
+    long long lastCost = -1;
+};
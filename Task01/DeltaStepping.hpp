@@ -0,0 +1,176 @@
+#pragma once
+#include "Grid.hpp"
+#include "Parallel.hpp"
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+// Parallel single-source shortest paths by delta-stepping. Cells are kept in
+// buckets of width delta by tentative distance; the lowest bucket is relaxed
+// by all threads at once, with atomic min updates on dist, until it stops
+// changing, then the next bucket is taken. Buckets are cyclic: every pending
+// distance is within one maximum step of the current bucket.
+//
+// Distances equal sequential Dijkstra exactly. prev is canonical rather than
+// whatever a queue's tie-breaking picks: see canonicalParents().
+class DeltaStepping
+{
+public:
+    int threads = hardwareThreads();
+    int delta = 0;  // bucket width; 0 picks the largest single step cost
+
+    template<class Neighborhood, class G>
+    void run(const G& grid, int start, std::vector<int>& dist, std::vector<int>& prev)
+    {
+        int n = grid.size();
+        int workers = std::max(1, threads);
+        std::unique_ptr<std::atomic<int>[]> d(new std::atomic<int>[n]);
+        stamp.assign(n, -1);
+        local.assign(workers, {});
+
+        std::vector<int> maxStep(workers, 1);
+        int width = delta, slots = 0, current = 0, phase = 0;
+        bool done = false;
+        frontier.clear();
+
+        // Collects the current bucket from every thread's lists, dropping
+        // duplicates and cells that have since moved to a lower bucket; moves
+        // on to the next non-empty bucket once the current one is settled.
+        auto nextFrontier = [&]
+        {
+            for (;;)
+            {
+                frontier.clear();
+                ++phase;
+                int slot = current % slots;
+                for (auto& buckets : local)
+                {
+                    for (int v : buckets[slot])
+                        if (stamp[v] != phase && d[v].load(std::memory_order_relaxed) / width == current)
+                        {
+                            stamp[v] = phase;
+                            frontier.push_back(v);
+                        }
+                    buckets[slot].clear();
+                }
+                if (!frontier.empty()) return;
+
+                int skipped = 0;
+                do
+                {
+                    ++current;
+                    bool any = false;
+                    for (auto& buckets : local) any |= !buckets[current % slots].empty();
+                    if (any) break;
+                } while (++skipped < slots);
+                if (skipped == slots)
+                {
+                    done = true;
+                    return;
+                }
+            }
+        };
+
+        std::atomic<int> cursor{ 0 };
+        Barrier barrier(workers, [&]
+        {
+            if (slots == 0)
+            {
+                int step = *std::max_element(maxStep.begin(), maxStep.end());
+                if (width <= 0) width = step;
+                slots = step / width + 2;
+                for (auto& buckets : local) buckets.assign(slots, {});
+                d[start] = 0;
+                frontier.push_back(start);
+            }
+            else
+            {
+                nextFrontier();
+            }
+            cursor = 0;
+        });
+
+        runThreads(workers, [&](int t)
+        {
+            // Each thread initialises its slice of dist and measures the
+            // largest step cost in it; the barrier then sizes the buckets.
+            int begin = int(std::int64_t(n) * t / workers), end = int(std::int64_t(n) * (t + 1) / workers);
+            for (int v = begin; v < end; ++v)
+            {
+                d[v].store(INF, std::memory_order_relaxed);
+                if (grid[v] == 1) continue;
+                for (int k = 0; k < Neighborhood::COUNT; ++k)
+                    maxStep[t] = std::max(maxStep[t], Neighborhood::template cost<int>(grid, v, k));
+            }
+            barrier.arriveAndWait();
+
+            const int chunk = 64;
+            while (!done)
+            {
+                int size = int(frontier.size());
+                for (int i; (i = cursor.fetch_add(chunk)) < size;)
+                    for (int j = i; j < std::min(i + chunk, size); ++j)
+                    {
+                        int u = frontier[j];
+                        int du = d[u].load(std::memory_order_relaxed);
+                        Neighborhood::forEach(grid, u, [&](int v, int k)
+                        {
+                            int nd = du + Neighborhood::template cost<int>(grid, v, k);
+                            int old = d[v].load(std::memory_order_relaxed);
+                            while (nd < old)
+                                if (d[v].compare_exchange_weak(old, nd, std::memory_order_relaxed))
+                                {
+                                    local[t][(nd / width) % slots].push_back(v);
+                                    break;
+                                }
+                        });
+                    }
+                barrier.arriveAndWait();
+            }
+        });
+
+        dist.resize(n);
+        for (int v = 0; v < n; ++v) dist[v] = d[v].load(std::memory_order_relaxed);
+        canonicalParents<Neighborhood>(grid, dist, prev, workers);
+    }
+
+    // prev[v] = the first neighbour u in forEach order with
+    // dist[u] + cost(u -> v) == dist[v]; -1 for the start and unreached cells.
+    // Any shortest-path tree maps to the same prev, so engines can be compared.
+    // Assumes symmetric moves: v -> u is legal iff u -> v is, at the same cost.
+    template<class Neighborhood, class G>
+    static void canonicalParents(const G& grid, const std::vector<int>& dist, std::vector<int>& prev,
+                                 int threads = 1)
+    {
+        int n = grid.size();
+        prev.assign(n, -1);
+        const int chunk = 4096;
+        parallelFor((n + chunk - 1) / chunk, threads, [&](int c)
+        {
+            for (int v = c * chunk; v < std::min(n, (c + 1) * chunk); ++v)
+            {
+                if (dist[v] == INF || dist[v] == 0) continue;
+                Neighborhood::forEach(grid, v, [&](int u, int k)
+                {
+                    if (prev[v] < 0 && dist[u] != INF &&
+                        dist[u] + Neighborhood::template cost<int>(grid, v, k) == dist[v])
+                        prev[v] = u;
+                });
+            }
+        });
+    }
+
+    std::size_t bytes() const
+    {
+        std::size_t b = stamp.capacity() * (sizeof(int) + sizeof(std::atomic<int>)) + frontier.capacity() * sizeof(int);
+        for (const auto& buckets : local)
+            for (const auto& bucket : buckets) b += bucket.capacity() * sizeof(int);
+        return b;
+    }
+
+private:
+    std::vector<int> stamp, frontier;
+    std::vector<std::vector<std::vector<int>>> local;  // [thread][bucket slot]
+};
@@ -0,0 +1,431 @@
+#pragma once
+#include "Search.hpp"
+#include "NeighborMask.hpp"
+#include "Landmarks.hpp"
+#include "Jps.hpp"
+#include "JpsPlus.hpp"
+#include "ContractionHierarchy.hpp"
+#include "Cpd.hpp"
+#include "GoalBounds.hpp"
+#include "SubgoalGraph.hpp"
+#include "Rsr.hpp"
+#include "QuadTree.hpp"
+#include "NavMesh.hpp"
+#include "ThetaStar.hpp"
+#include "PathSmoothing.hpp"
+#include "PathCache.hpp"
+#include "Speculation.hpp"
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// Engines selectable at runtime by the viewer (E) and the headless runner.
+enum class Engine { Dijkstra, AStar, AStar8, Alt, Jps, JpsPlus, Ch, Cpd, Subgoal, Quadtree, NavMesh, Theta, Count };
+
+static constexpr int ENGINE_COUNT = int(Engine::Count);
+static constexpr const char* ENGINE_NAMES[ENGINE_COUNT] = { "dijkstra", "astar", "astar8", "alt", "jps", "jps+", "ch", "cpd", "ssg", "quad", "navmesh", "theta" };
+
+inline Engine engineFromName(const char* name, Engine fallback)
+{
+    for (int e = 0; e < ENGINE_COUNT; ++e)
+        if (std::strcmp(name, ENGINE_NAMES[e]) == 0) return Engine(e);
+    return fallback;
+}
+
+// Owns the search buffers so repeated queries reuse their allocations. In
+// compact mode the distance type is picked per map from maxSearchKey().
+class PathFinder
+{
+public:
+    Engine engine = Engine::Dijkstra;
+    bool compact = false;
+    bool goalBounding = false;  // dijkstra, astar, astar8, jps and jps+; tables built on first use
+    bool symmetryReduction = false;  // dijkstra and astar over empty rectangles; overrides goalBounding
+    bool smoothPaths = false;  // waypoints() string-pulls cell paths
+    bool cachePaths = false;   // answer repeated queries from cache; not navmesh or theta
+    bool speculate = false;    // answer exact engines from a tree flooded in the background; see prepare()
+    int landmarkCount = 8;
+
+    // ALT tables, JPS+ jump distances, the contraction hierarchy, the path
+    // database, the goal bounds, the subgoal graph, the empty rectangles, the
+    // quadtree, the navigation mesh and the line-of-sight bits, built on
+    // first use for the grid being searched. Assign or load prebuilt ones
+    // here; call gridChanged() after editing walls to drop them all, or
+    // cellChanged() after a single toggle. That still drops the ALT tables,
+    // the contraction hierarchy, the path database and the goal bounds, but
+    // patches the jump table, subgoal graph, rectangles, quadtree, navigation
+    // mesh, line-of-sight bits and path cache; the speculative tree is kept
+    // for a goal picked on a wall and otherwise flooded again.
+    LandmarkHeuristic<int> landmarks;
+    JpsPlus jpsPlus;
+    ContractionHierarchy hierarchy;
+    CompressedPathDatabase database;
+    SubgoalGraph subgoals;
+    EmptyRectangles rectangles;
+    QuadTree quadtree;
+    NavMesh navmesh;
+    ThetaStar theta;
+    PathCache cache;
+    SpeculativeTree speculation;
+
+    void gridChanged()
+    {
+        dropTables();
+        speculation.drop();
+    }
+
+    // With speculate, starts flooding the shortest-path tree from startIdx
+    // in the background, e.g. as soon as the start is picked. Once it is
+    // done, find() from that start walks the tree instead of searching; a
+    // search from any other start floods a new tree after it.
+    template<class G>
+    void prepare(const G& grid, int startIdx)
+    {
+        if (speculate && servedByTree() && !speculation.covers(startIdx, eightConnected()))
+            speculation.start(grid, startIdx, eightConnected());
+    }
+
+    template<class G>
+    void cellChanged(const G& grid, int x, int y)
+    {
+        JumpTable jumps = std::move(jpsPlus.jumps);
+        SubgoalGraph graph = std::move(subgoals);
+        EmptyRectangles rects = std::move(rectangles);
+        QuadTree tree = std::move(quadtree);
+        NavMesh mesh = std::move(navmesh);
+        ThetaStar anyAngle = std::move(theta);
+        PathCache paths = std::move(cache);
+        dropTables();
+        jumps.update(grid, x, y);
+        jpsPlus.jumps = std::move(jumps);
+        updateSubgoals(graph, grid, x, y);
+        subgoals = std::move(graph);
+        rects.update(grid, x, y);
+        rectangles = std::move(rects);
+        tree.update(grid, x, y);
+        quadtree = std::move(tree);
+        mesh.update(grid, x, y);
+        navmesh = std::move(mesh);
+        anyAngle.update(grid, x, y);
+        theta = std::move(anyAngle);
+        paths.cellChanged(grid, x, y);
+        cache = std::move(paths);
+        speculation.cellChanged(grid, grid.idx(x, y));
+    }
+
+    template<class N, class G>
+    const LandmarkHeuristic<int>& landmarksFor(const G& grid)
+    {
+        if (landmarks.tables.empty() || int(landmarks.tables[0].size()) != grid.size())
+            landmarks = selectLandmarks<N, int>(grid, landmarkCount);
+        return landmarks;
+    }
+
+    template<class N, class G>
+    GoalBounds& boundsFor(const G& grid)
+    {
+        GoalBounds& b = N::COUNT == 4 ? bounds4 : bounds8;
+        if (b.empty() || !b.matches(grid.width, grid.height)) b.build<N>(grid);
+        return b;
+    }
+
+    template<class G>
+    JumpTable& jumpTableFor(const G& grid)
+    {
+        if (jpsPlus.jumps.empty() || !jpsPlus.jumps.matches(grid.width, grid.height))
+            jpsPlus.jumps.build(grid);
+        return jpsPlus.jumps;
+    }
+
+    template<class N, class G>
+    ContractionHierarchy& hierarchyFor(const G& grid)
+    {
+        if (hierarchy.empty() || !hierarchy.matches(grid.width, grid.height, grid.size()))
+            hierarchy.build<N>(grid);
+        return hierarchy;
+    }
+
+    template<class N, class G>
+    CompressedPathDatabase& databaseFor(const G& grid)
+    {
+        if (database.empty() || !database.matches(grid.width, grid.height, grid.size()))
+            database.build<N>(grid);
+        return database;
+    }
+
+    template<class N, class G>
+    SubgoalGraph& subgoalsFor(const G& grid)
+    {
+        if (subgoals.empty() || !subgoals.matches(grid.width, grid.height)) subgoals.build<N>(grid);
+        return subgoals;
+    }
+
+    template<class G>
+    EmptyRectangles& rectanglesFor(const G& grid)
+    {
+        if (rectangles.empty() || !rectangles.matches(grid.width, grid.height)) rectangles.build(grid);
+        return rectangles;
+    }
+
+    template<class G>
+    QuadTree& quadtreeFor(const G& grid)
+    {
+        if (quadtree.empty() || !quadtree.matches(grid.width, grid.height)) quadtree.build(grid);
+        return quadtree;
+    }
+
+    template<class G>
+    NavMesh& navMeshFor(const G& grid)
+    {
+        if (navmesh.empty() || !navmesh.matches(grid.width, grid.height)) navmesh.build(grid);
+        return navmesh;
+    }
+
+    template<class G>
+    ThetaStar& thetaFor(const G& grid)
+    {
+        if (theta.empty() || !theta.matches(grid.width, grid.height)) theta.build(grid);
+        return theta;
+    }
+
+    // Shared with theta.
+    template<class G>
+    const LineOfSight& lineOfSightFor(const G& grid) { return thetaFor(grid).lineOfSight(); }
+
+    bool find(const Grid& grid, int startIdx, int goalIdx,
+              std::vector<int>& path, SearchStats& stats)
+    {
+        return cached(grid, startIdx, goalIdx, path, stats, [&]
+        {
+            return dispatch<Neighborhood4, Neighborhood8>(grid, startIdx, goalIdx, path, stats);
+        });
+    }
+
+    // Same engines driven by the precomputed move masks.
+    bool find(const MaskedGrid<Grid>& grid, int startIdx, int goalIdx,
+              std::vector<int>& path, SearchStats& stats)
+    {
+        return cached(grid, startIdx, goalIdx, path, stats, [&]
+        {
+            return dispatch<MaskedNeighborhood4, MaskedNeighborhood8>(grid, startIdx, goalIdx, path, stats);
+        });
+    }
+
+    // Points to move through along the last path: the corners for navmesh
+    // and theta, otherwise the cell centres, or with smoothPaths the centres
+    // of the string-pulled corners.
+    template<class G>
+    void waypoints(const G& grid, const std::vector<int>& path, std::vector<Waypoint>& out)
+    {
+        if (engine == Engine::NavMesh && !path.empty()) out = navmesh.polyline();
+        else if (engine == Engine::Theta && !path.empty()) out = theta.polyline();
+        else if (!smoothPaths) cellWaypoints(grid, path, out);
+        else
+        {
+            smoothPath(grid, lineOfSightFor(grid), path, corners);
+            cellWaypoints(grid, corners, out);
+        }
+    }
+
+    // Cost of the last path found, in the engine's units.
+    long long cost() const { return lastCost; }
+
+    // Bytes held by the distance/predecessor buffers of the last search.
+    std::size_t storageBytes() const { return lastBytes; }
+
+private:
+    // Everything gridChanged() drops but the speculative tree.
+    void dropTables()
+    {
+        landmarks = LandmarkHeuristic<int>{};
+        jpsPlus.jumps = JumpTable{};
+        hierarchy = ContractionHierarchy{};
+        database = CompressedPathDatabase{};
+        bounds4 = GoalBounds{};
+        bounds8 = GoalBounds{};
+        subgoals = SubgoalGraph{};
+        rectangles = EmptyRectangles{};
+        quadtree = QuadTree{};
+        navmesh = NavMesh{};
+        theta = ThetaStar{};
+        cache.clear();
+    }
+
+    bool eightConnected() const
+    {
+        return engine == Engine::AStar8 || engine == Engine::Jps || engine == Engine::JpsPlus ||
+               engine == Engine::Subgoal;
+    }
+
+    // Engines whose answer is just an optimal cell path, which any
+    // shortest-path tree over the same moves can stand in for.
+    bool servedByTree() const
+    {
+        return engine != Engine::Quadtree && engine != Engine::NavMesh && engine != Engine::Theta;
+    }
+
+    // Cache, then speculative tree, then run(). Answers that did not search
+    // leave stats zeroed.
+    template<class G, class Search>
+    bool cached(const G& grid, int s, int g, std::vector<int>& path, SearchStats& stats, Search&& run)
+    {
+        bool useCache = cachePaths && engine != Engine::NavMesh && engine != Engine::Theta;
+        if (useCache && cache.lookup(grid, s, g, int(engine), path, lastCost))
+        {
+            stats = SearchStats{};
+            lastBytes = cache.bytes();
+            return true;
+        }
+        bool found;
+        if (speculate && servedByTree() && speculation.ready(s, g, eightConnected()))
+        {
+            found = speculation.pathTo(g, path);
+            stats = SearchStats{};
+            lastCost = speculation.cost(g);
+            lastBytes = speculation.bytes();
+        }
+        else found = run();
+        prepare(grid, s);
+        if (!useCache || !found) return found;
+        PathUnits units = eightConnected() ? PathUnits{ Neighborhood8::straight<int>(), Neighborhood8::diagonal<int>() }
+                                           : PathUnits{ Neighborhood4::straight<int>(), Neighborhood4::diagonal<int>() };
+        cache.store(grid, s, g, int(engine), path, lastCost, engine != Engine::Quadtree, units);
+        return true;
+    }
+
+    template<class N4, class N8, class G>
+    bool dispatch(const G& grid, int s, int g, std::vector<int>& path, SearchStats& stats)
+    {
+        switch (engine)
+        {
+        case Engine::Dijkstra:
+            if (symmetryReduction) return runReduced(grid, s, g, path, stats, zero);
+            return runBounded<N4>(grid, s, g, path, stats, zero);
+        case Engine::AStar:
+            if (symmetryReduction) return runReduced(grid, s, g, path, stats, manhattan);
+            return runBounded<N4>(grid, s, g, path, stats, manhattan);
+        case Engine::AStar8:
+            return runBounded<N8>(grid, s, g, path, stats, octile);
+        case Engine::Alt:
+            landmarksFor<N4>(grid);
+            return run<N4>(grid, s, g, path, stats, landmarks);
+        case Engine::Jps:
+            jps.bounds = goalBounding ? &boundsFor<N8>(grid) : nullptr;
+            return finish(jps, jps.find<true>(grid, s, g, path, stats));
+        case Engine::JpsPlus:
+            jpsPlus.bounds = goalBounding ? &boundsFor<N8>(grid) : nullptr;
+            jumpTableFor(grid);
+            return finish(jpsPlus, jpsPlus.find<true>(grid, s, g, path, stats));
+        case Engine::Ch:
+            hierarchyFor<N4>(grid);
+            return finish(hierarchy, hierarchy.find<true>(grid, s, g, path, stats));
+        case Engine::Cpd:
+            databaseFor<N4>(grid);
+            return finish(database, database.find<N4, true>(grid, s, g, path, stats));
+        case Engine::Subgoal:
+            subgoalsFor<N8>(grid);
+            return finish(subgoals, subgoals.find<N8, true>(grid, s, g, path, stats));
+        case Engine::Quadtree:
+            quadtreeFor(grid);
+            return finish(quadtree, quadtree.find<true>(grid, s, g, path, stats));
+        case Engine::NavMesh:
+            navMeshFor(grid);
+            return finish(navmesh, navmesh.find<true>(grid, s, g, path, stats));
+        case Engine::Theta:
+            thetaFor(grid);
+            return finish(theta, theta.find<N8, true>(grid, s, g, path, stats));
+        default:
+            return false;
+        }
+    }
+
+    // The engine searches the 8-connected graph.
+    static void updateSubgoals(SubgoalGraph& graph, const Grid& grid, int x, int y)
+    {
+        graph.update<Neighborhood8>(grid, x, y);
+    }
+    static void updateSubgoals(SubgoalGraph& graph, const MaskedGrid<Grid>& grid, int x, int y)
+    {
+        graph.update<MaskedNeighborhood8>(grid, x, y);
+    }
+
+    template<class E>
+    bool finish(const E& e, bool found)
+    {
+        lastBytes = e.bytes();
+        lastCost = e.cost();
+        return found;
+    }
+
+    template<class N, class H, class G>
+    bool runBounded(const G& grid, int s, int g, std::vector<int>& path, SearchStats& stats, H& h)
+    {
+        if (!goalBounding) return run<N>(grid, s, g, path, stats, h);
+        GoalBoundedHeuristic<H> bounded;
+        static_cast<H&>(bounded) = h;
+        bounded.bounds = &boundsFor<N>(grid);
+        return run<N>(grid, s, g, path, stats, bounded);
+    }
+
+    // Full storage only: reduced moves carry a length.
+    template<class H, class G>
+    bool runReduced(const G& grid, int s, int g, std::vector<int>& path, SearchStats& stats, H& h)
+    {
+        ReducedGrid<G> reduced{ grid, rectanglesFor(grid), g };
+        bool found = runWith<RsrNeighborhood4, RadixHeapQueue<int>>(reduced, s, g, path, stats, h, full);
+        expandReducedPath(grid, path);
+        return found;
+    }
+
+    template<class N, class H, class G>
+    bool run(const G& grid, int s, int g, std::vector<int>& path, SearchStats& stats, H& h)
+    {
+        if (!compact)
+            return runWith<N, RadixHeapQueue<int>>(grid, s, g, path, stats, h, full);
+        if (maxSearchKey<N>(grid) < distInf<std::uint16_t>())
+            return runWith<N, RadixHeapQueue<std::uint16_t>>(grid, s, g, path, stats, h,
+                                                              compactStore<N, std::uint16_t>());
+        return runWith<N, RadixHeapQueue<std::uint32_t>>(grid, s, g, path, stats, h,
+                                                          compactStore<N, std::uint32_t>());
+    }
+
+    template<class N, class Queue, class Storage, class H, class G>
+    bool runWith(const G& grid, int s, int g, std::vector<int>& path, SearchStats& stats,
+                 H& h, Storage& store)
+    {
+        search<N, H, Queue, Storage, true>(grid, s, g, store, stats, h);
+        lastBytes = store.bytes();
+        lastCost = store.reached(g) ? (long long)store.get(g) : -1;
+        return buildPath(grid, store, g, path);
+    }
+
+    template<class N, class D>
+    auto& compactStore()
+    {
+        if constexpr (N::COUNT == 4)
+        {
+            if constexpr (std::is_same<D, std::uint16_t>::value) return c16n4;
+            else return c32n4;
+        }
+        else
+        {
+            if constexpr (std::is_same<D, std::uint16_t>::value) return c16n8;
+            else return c32n8;
+        }
+    }
+
+    FullStorage<int> full;
+    CompactStorage<std::uint16_t, Neighborhood4> c16n4;
+    CompactStorage<std::uint32_t, Neighborhood4> c32n4;
+    CompactStorage<std::uint16_t, Neighborhood8> c16n8;
+    CompactStorage<std::uint32_t, Neighborhood8> c32n8;
+    ZeroHeuristic zero;
+    ManhattanHeuristic manhattan;
+    OctileHeuristic octile;
+    JumpPointSearch jps;
+    std::vector<int> corners;
+    GoalBounds bounds4, bounds8;
+    long long lastCost = -1;
+    std::size_t lastBytes = 0;
+};
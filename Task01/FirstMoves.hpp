@@ -0,0 +1,60 @@
+#pragma once
+#include "Grid.hpp"
+#include "PriorityQueue.hpp"
+#include <vector>
+#include <cstdint>
+
+// One Dijkstra from a source that records, for every reached cell, the set
+// of moves out of the source that start a shortest path to it: bit k of
+// first[v] is set iff some shortest source..v path begins with move k.
+// Buffers persist across runs; only the cells touched last time are reset.
+struct FirstMoveSearch
+{
+    std::vector<int> dist, touched;    // touched: every reached cell, source first
+    std::vector<std::uint8_t> first;
+
+    template<class Neighborhood, class G>
+    void run(const G& grid, int start)
+    {
+        static_assert(Neighborhood::COUNT <= 8, "first-move sets are 8-bit masks");
+        if (int(dist.size()) != grid.size())
+        {
+            dist.assign(grid.size(), INF);
+            first.assign(grid.size(), 0);
+            touched.clear();
+        }
+        for (int v : touched)
+        {
+            dist[v] = INF;
+            first[v] = 0;
+        }
+        touched.clear();
+
+        RadixHeapQueue<int> pq;
+        pq.reset(grid.size());
+        dist[start] = 0;
+        touched.push_back(start);
+        pq.push(0, start);
+        while (!pq.empty())
+        {
+            auto [d, u] = pq.pop();
+            if (d > dist[u]) continue;
+            Neighborhood::forEach(grid, u, [&](int v, int k)
+            {
+                int nd = d + Neighborhood::template cost<int>(grid, v, k);
+                std::uint8_t via = u == start ? std::uint8_t(1u << k) : first[u];
+                if (nd < dist[v])
+                {
+                    if (dist[v] == INF) touched.push_back(v);
+                    dist[v] = nd;
+                    first[v] = via;
+                    pq.push(nd, v);
+                }
+                else if (nd == dist[v])
+                {
+                    first[v] |= via;
+                }
+            });
+        }
+    }
+};
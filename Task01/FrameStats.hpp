@@ -0,0 +1,136 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdio>
+
+enum class Phase { Events, Search, Animation, TileDraw, OverlayDraw, Display, Count };
+
+static constexpr int PHASE_COUNT = int(Phase::Count);
+static constexpr const char* PHASE_NAMES[PHASE_COUNT] = {
+    "events", "search", "anim", "tiles", "overlay", "display"
+};
+
+// Rolling window of per-phase frame times. mark() closes the current phase,
+// commit() closes the frame; display includes the framerate limiter's sleep.
+class FrameStats
+{
+public:
+    static constexpr int HISTORY = 240;
+
+    struct Sample
+    {
+        float phase[PHASE_COUNT] = {};
+        float total = 0.f;
+    };
+
+    FrameStats() : last(Clock::now()), frameStart(last) {}
+
+    void mark(Phase p)
+    {
+        auto now = Clock::now();
+        current.phase[int(p)] += ms(last, now);
+        last = now;
+    }
+
+    void commit()
+    {
+        auto now = Clock::now();
+        current.total = ms(frameStart, now);
+        ring[head] = current;
+        head = (head + 1) % HISTORY;
+        count = std::min(count + 1, HISTORY);
+        current = Sample{};
+        last = frameStart = now;
+    }
+
+    int size() const { return count; }
+
+    // i = 0 is the oldest sample in the window.
+    const Sample& at(int i) const { return ring[(head - count + i + HISTORY) % HISTORY]; }
+
+    float percentile(float p) const
+    {
+        if (count == 0) return 0.f;
+        scratch.resize(count);
+        for (int i = 0; i < count; ++i) scratch[i] = at(i).total;
+        auto nth = scratch.begin() + std::min(count - 1, int(p * count));
+        std::nth_element(scratch.begin(), nth, scratch.end());
+        return *nth;
+    }
+
+    float mean(Phase p) const
+    {
+        if (count == 0) return 0.f;
+        float sum = 0.f;
+        for (int i = 0; i < count; ++i) sum += at(i).phase[int(p)];
+        return sum / count;
+    }
+
+    std::string summary() const
+    {
+        char buf[96];
+        float p50 = percentile(0.50f);
+        std::snprintf(buf, sizeof(buf), "frame p50 %.2f  p95 %.2f  p99 %.2f ms  (%d fps)",
+                      p50, percentile(0.95f), percentile(0.99f), p50 > 0.f ? int(1000.f / p50) : 0);
+        std::string s = buf;
+        s += "\n";
+        for (int k = 0; k < PHASE_COUNT; ++k)
+        {
+            std::snprintf(buf, sizeof(buf), "%s %.2f  ", PHASE_NAMES[k], mean(Phase(k)));
+            s += buf;
+        }
+        return s;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static float ms(Clock::time_point a, Clock::time_point b)
+    {
+        return std::chrono::duration<float, std::milli>(b - a).count();
+    }
+
+    std::array<Sample, HISTORY> ring{};
+    int head = 0, count = 0;
+    Sample current;
+    Clock::time_point last, frameStart;
+    mutable std::vector<float> scratch;
+};
+
+static const sf::Color PHASE_COLORS[PHASE_COUNT] = {
+    { 200, 200, 200 }, { 255, 80, 80 }, { 255, 200, 0 },
+    { 80, 160, 255 }, { 160, 100, 255 }, { 80, 200, 80 }
+};
+
+// Stacked per-phase bars, newest on the right, with a line at the 60 fps budget.
+inline void buildFrameGraph(const FrameStats& stats, sf::VertexArray& va,
+                            sf::Vector2f origin, float pxPerMs, float barWidth)
+{
+    va.setPrimitiveType(sf::PrimitiveType::Triangles);
+    va.clear();
+    auto quad = [&](float x, float y0, float y1, float w, sf::Color c)
+    {
+        sf::Vector2f a{ x, y0 }, b{ x + w, y0 }, d{ x, y1 }, e{ x + w, y1 };
+        va.append({ a, c }); va.append({ b, c }); va.append({ e, c });
+        va.append({ a, c }); va.append({ e, c }); va.append({ d, c });
+    };
+
+    for (int i = 0; i < stats.size(); ++i)
+    {
+        const auto& s = stats.at(i);
+        float x = origin.x + i * barWidth;
+        float y = origin.y;
+        for (int k = 0; k < PHASE_COUNT; ++k)
+        {
+            float h = s.phase[k] * pxPerMs;
+            quad(x, y - h, y, barWidth, PHASE_COLORS[k]);
+            y -= h;
+        }
+    }
+    float budget = origin.y - (1000.f / 60.f) * pxPerMs;
+    quad(origin.x, budget, budget + 1.f, FrameStats::HISTORY * barWidth, { 255, 255, 255, 120 });
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "FirstMoves.hpp"
+#include "Parallel.hpp"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Goal bounding: for every cell u and move k, the bounding box of all goals
+// some shortest path from u reaches through move k. A goal outside the box
+// proves move k is never the first step of a shortest path from u, so the
+// move can be skipped without losing optimality. Built with one first-move
+// Dijkstra per source, sources spread over threads.
+class GoalBounds
+{
+public:
+    int threads = hardwareThreads();
+
+    template<class Neighborhood, class G>
+    void build(const G& grid)
+    {
+        moves = Neighborhood::COUNT;
+        width = grid.width;
+        height = grid.height;
+        boxes.assign(std::size_t(grid.size()) * moves, Box{});
+
+        std::vector<int> sources;
+        for (int v = 0; v < grid.size(); ++v)
+            if (grid[v] != 1) sources.push_back(v);
+        std::vector<FirstMoveSearch> scratch(std::max(1, threads));
+        std::atomic<int> next{ 0 };
+        runThreads(std::max(1, std::min<int>(threads, int(sources.size()))), [&](int t)
+        {
+            FirstMoveSearch& search = scratch[t];
+            for (int i; (i = next.fetch_add(1)) < int(sources.size());)
+            {
+                int s = sources[i];
+                search.run<Neighborhood>(grid, s);
+                Box* out = &boxes[std::size_t(s) * moves];
+                for (std::size_t j = 1; j < search.touched.size(); ++j)
+                {
+                    int v = search.touched[j];
+                    int x = grid.x(v), y = grid.y(v);
+                    for (unsigned m = search.first[v]; m; m &= m - 1) out[lowestBit(m)].add(x, y);
+                }
+            }
+        });
+    }
+
+    // True unless goal lies outside the box of move k out of u.
+    template<class G>
+    bool allows(const G& grid, int u, int k, int goal) const
+    {
+        const Box& b = boxes[std::size_t(u) * moves + k];
+        int x = grid.x(goal), y = grid.y(goal);
+        return x >= b.x0 && x <= b.x1 && y >= b.y0 && y <= b.y1;
+    }
+
+    bool empty() const { return boxes.empty(); }
+    bool matches(int w, int h) const { return width == w && height == h; }
+    std::size_t bytes() const { return boxes.capacity() * sizeof(Box); }
+
+private:
+    struct Box
+    {
+        std::int16_t x0 = INT16_MAX, y0 = INT16_MAX, x1 = -1, y1 = -1;  // empty until a goal is added
+
+        void add(int x, int y)
+        {
+            x0 = std::min<std::int16_t>(x0, std::int16_t(x));
+            y0 = std::min<std::int16_t>(y0, std::int16_t(y));
+            x1 = std::max<std::int16_t>(x1, std::int16_t(x));
+            y1 = std::max<std::int16_t>(y1, std::int16_t(y));
+        }
+    };
+
+    int moves = 0, width = 0, height = 0;
+    std::vector<Box> boxes;  // [cell * moves + k]
+};
+
+// Wraps any heuristic with goal-bounding pruning; search<>() asks allows()
+// before each relaxation. The tables must come from the same neighborhood.
+template<class H>
+struct GoalBoundedHeuristic : H
+{
+    const GoalBounds* bounds = nullptr;
+    int goal = -1;
+
+    template<class G> void setGoal(const G& g, int goalIdx)
+    {
+        H::setGoal(g, goalIdx);
+        goal = goalIdx;
+    }
+    template<class G> bool allows(const G& g, int u, int k) const
+    {
+        return bounds->allows(g, u, k, goal);
+    }
+};
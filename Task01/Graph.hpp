@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+// Explicit adjacency of a grid's passable cells in CSR form. Nodes are the
+// floor cells numbered in slot order; nodeOf maps a slot back (-1 for walls).
+// Edge e of node u is targets[e], weights[e] for e in [offsets[u], offsets[u+1]).
+struct GridGraph
+{
+    std::vector<int> cellOf, nodeOf;
+    std::vector<int> offsets, targets, weights;
+
+    int nodes() const { return int(cellOf.size()); }
+    int edges() const { return int(targets.size()); }
+
+    template<class Neighborhood, class G>
+    static GridGraph build(const G& grid)
+    {
+        GridGraph g;
+        g.nodeOf.assign(grid.size(), -1);
+        for (int v = 0; v < grid.size(); ++v)
+            if (grid[v] != 1)
+            {
+                g.nodeOf[v] = int(g.cellOf.size());
+                g.cellOf.push_back(v);
+            }
+        g.offsets.reserve(g.cellOf.size() + 1);
+        g.offsets.push_back(0);
+        for (int u : g.cellOf)
+        {
+            Neighborhood::forEach(grid, u, [&](int v, int k)
+            {
+                g.targets.push_back(g.nodeOf[v]);
+                g.weights.push_back(Neighborhood::template cost<int>(grid, v, k));
+            });
+            g.offsets.push_back(int(g.targets.size()));
+        }
+        return g;
+    }
+
+    std::size_t bytes() const
+    {
+        return (cellOf.capacity() + nodeOf.capacity() + offsets.capacity() + targets.capacity() +
+                weights.capacity()) * sizeof(int);
+    }
+};
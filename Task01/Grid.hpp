@@ -0,0 +1,144 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+
+static constexpr int INF = std::numeric_limits<int>::max();
+static constexpr int dx[4] = { 1, -1,  0,  0 };
+static constexpr int dy[4] = { 0,  0,  1, -1 };
+
+// Cell layouts map (x, y) to a storage slot and back. slots() may exceed
+// width * height; padding slots are stored as walls so engines never enter them.
+struct RowMajorLayout
+{
+    int width = 0;
+
+    RowMajorLayout() = default;
+    RowMajorLayout(int w, int) : width(w) {}
+    int slots(int, int h) const { return width * h; }
+    int idx(int x, int y) const { return y * width + x; }
+    int x(int i) const { return i % width; }
+    int y(int i) const { return i / width; }
+    int step(int i, int ddx, int ddy) const { return i + ddy * width + ddx; }
+};
+
+constexpr int log2Floor(int n) { return n > 1 ? 1 + log2Floor(n / 2) : 0; }
+
+// T x T tiles stored one after another, row-major inside a tile, so the
+// vertical neighbours of most cells are T slots away instead of a whole row.
+template<int T = 8>
+struct TiledLayout
+{
+    static_assert(T > 0 && (T & (T - 1)) == 0, "tile side must be a power of two");
+    static constexpr int SHIFT = log2Floor(T);
+    int tilesX = 0;
+
+    TiledLayout() = default;
+    TiledLayout(int w, int) : tilesX((w + T - 1) / T) {}
+    int slots(int, int h) const { return tilesX * ((h + T - 1) / T) * T * T; }
+    int idx(int x, int y) const
+    {
+        return (((y >> SHIFT) * tilesX + (x >> SHIFT)) << (2 * SHIFT)) + ((y & (T - 1)) << SHIFT) + (x & (T - 1));
+    }
+    int x(int i) const { return ((i >> (2 * SHIFT)) % tilesX << SHIFT) + (i & (T - 1)); }
+    int y(int i) const { return ((i >> (2 * SHIFT)) / tilesX << SHIFT) + ((i >> SHIFT) & (T - 1)); }
+    int step(int i, int ddx, int ddy) const { return idx(x(i) + ddx, y(i) + ddy); }
+};
+
+// Z-order (Morton) inside 64 x 64 blocks, blocks row-major. Blocks keep the
+// padding of wide, non-square maps to under 64 cells per side while giving
+// Z-order locality at every scale up to 4096 cells.
+struct MortonLayout
+{
+    static constexpr int B = 64;
+    int blocksX = 0;
+
+    MortonLayout() = default;
+    MortonLayout(int w, int) : blocksX((w + B - 1) / B) {}
+    int slots(int, int h) const { return blocksX * ((h + B - 1) / B) * B * B; }
+    int idx(int x, int y) const
+    {
+        return (((y >> 6) * blocksX + (x >> 6)) << 12) | int(spread(x & 63) | (spread(y & 63) << 1));
+    }
+    int x(int i) const { return ((i >> 12) % blocksX << 6) | compact(i & 0xFFF); }
+    int y(int i) const { return ((i >> 12) / blocksX << 6) | compact((i & 0xFFF) >> 1); }
+    int step(int i, int ddx, int ddy) const { return idx(x(i) + ddx, y(i) + ddy); }
+
+    static std::uint32_t spread(std::uint32_t v)
+    {
+        v = (v | (v << 4)) & 0x0F0F;
+        v = (v | (v << 2)) & 0x3333;
+        v = (v | (v << 1)) & 0x5555;
+        return v;
+    }
+    static int compact(std::uint32_t v)
+    {
+        v &= 0x5555;
+        v = (v | (v >> 1)) & 0x3333;
+        v = (v | (v >> 2)) & 0x0F0F;
+        v = (v | (v >> 4)) & 0x00FF;
+        return int(v);
+    }
+};
+
+// Passability store shared by the viewer and every search engine: 1 = wall, 0 = floor.
+// Indices are layout slots; engines only go through idx/x/y, never raw arithmetic.
+template<class Layout>
+struct BasicGrid
+{
+    int width = 0, height = 0;
+    Layout layout;
+    std::vector<int> cells;
+
+    BasicGrid() = default;
+    BasicGrid(int w, int h)
+        : width(w), height(h), layout(w, h), cells(std::size_t(layout.slots(w, h)), 0)
+    {
+        for (int i = 0; i < size(); ++i)
+            if (!inside(x(i), y(i))) cells[i] = 1;
+    }
+
+    int size() const { return int(cells.size()); }
+    int idx(int x, int y) const { return layout.idx(x, y); }
+    int x(int i) const { return layout.x(i); }
+    int y(int i) const { return layout.y(i); }
+    // Slot of the cell (ddx, ddy) away from slot i; the target must be inside.
+    int step(int i, int ddx, int ddy) const { return layout.step(i, ddx, ddy); }
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+
+    int& operator[](int i) { return cells[i]; }
+    int operator[](int i) const { return cells[i]; }
+};
+
+using Grid = BasicGrid<RowMajorLayout>;
+
+// FNV-1a over the wall bits, slot by slot. Saved tables carry it so they
+// are only loaded back onto the walls they were built for.
+template<class G>
+std::uint32_t wallHash(const G& grid)
+{
+    std::uint32_t h = 2166136261u;
+    for (int i = 0; i < grid.size(); ++i) h = (h ^ std::uint32_t(grid[i] == 1)) * 16777619u;
+    return h;
+}
+
+template<class Layout, class From>
+BasicGrid<Layout> relayout(const BasicGrid<From>& src)
+{
+    BasicGrid<Layout> dst(src.width, src.height);
+    for (int y = 0; y < src.height; ++y)
+        for (int x = 0; x < src.width; ++x)
+            dst[dst.idx(x, y)] = src[src.idx(x, y)];
+    return dst;
+}
+
+inline void fillRandom(Grid& grid, int walls)
+{
+    for (int i = 0; i < walls; ++i) {
+        int x = std::rand() % grid.width;
+        int y = std::rand() % grid.height;
+        grid[grid.idx(x, y)] = 1;
+    }
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include "Search.hpp"
+#include "GoalBounds.hpp"
+#include <vector>
+#include <algorithm>
+
+template<class G>
+inline bool jpsWalkable(const G& grid, int x, int y)
+{
+    return grid.inside(x, y) && grid[grid.idx(x, y)] != 1;
+}
+
+// Neighborhood8 move index of the unit step (dx, dy).
+inline int jpsDirection(int dx, int dy)
+{
+    static constexpr int INDEX[3][3] = { { 7, 3, 6 }, { 1, -1, 0 }, { 5, 2, 4 } };
+    return INDEX[dy + 1][dx + 1];
+}
+
+// Jump policy of the online search: scans cell by cell. Straight scans stop
+// where a side cell opens up behind a wall; diagonal scans stop where either
+// straight scan finds something. jump() returns the next jump point from
+// (x, y) in direction (dx, dy), the goal if it comes first, or -1.
+struct ScanJumps
+{
+    template<class G>
+    int jump(const G& grid, int x, int y, int dx, int dy, int goal) const
+    {
+        return dx != 0 && dy != 0 ? jumpDiagonal(grid, x, y, dx, dy, goal) : jumpStraight(grid, x, y, dx, dy, goal);
+    }
+
+    std::size_t bytes() const { return 0; }
+
+private:
+    template<class G>
+    static int jumpStraight(const G& grid, int x, int y, int dx, int dy, int goal)
+    {
+        for (;;)
+        {
+            x += dx;
+            y += dy;
+            if (!jpsWalkable(grid, x, y)) return -1;
+            int v = grid.idx(x, y);
+            if (v == goal) return v;
+            if (dx != 0)
+            {
+                if ((jpsWalkable(grid, x, y - 1) && !jpsWalkable(grid, x - dx, y - 1)) ||
+                    (jpsWalkable(grid, x, y + 1) && !jpsWalkable(grid, x - dx, y + 1)))
+                    return v;
+            }
+            else if ((jpsWalkable(grid, x - 1, y) && !jpsWalkable(grid, x - 1, y - dy)) ||
+                     (jpsWalkable(grid, x + 1, y) && !jpsWalkable(grid, x + 1, y - dy)))
+            {
+                return v;
+            }
+        }
+    }
+
+    template<class G>
+    static int jumpDiagonal(const G& grid, int x, int y, int dx, int dy, int goal)
+    {
+        for (;;)
+        {
+            if (!jpsWalkable(grid, x + dx, y) || !jpsWalkable(grid, x, y + dy)) return -1;
+            x += dx;
+            y += dy;
+            if (!jpsWalkable(grid, x, y)) return -1;
+            int v = grid.idx(x, y);
+            if (v == goal) return v;
+            if (jumpStraight(grid, x, y, dx, 0, goal) >= 0 || jumpStraight(grid, x, y, 0, dy, goal) >= 0) return v;
+        }
+    }
+};
+
+// Jump point search over Neighborhood8 moves (no corner cutting, costs
+// 10/14), with the jumps themselves left to the Jumps policy. Every edge
+// between jump points is a straight or diagonal line, so costs are octile and
+// buildPath() fills the cells between jump points back in. With bounds set
+// (goal bounding over Neighborhood8), jumps whose first move cannot start a
+// shortest path to the goal are skipped.
+template<class Jumps>
+class BasicJumpPointSearch
+{
+public:
+    Jumps jumps;
+    const GoalBounds* bounds = nullptr;
+
+    template<bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        store.reset(grid.size());
+        store.setStart(startIdx);
+        heuristic.setGoal(grid, goalIdx);
+        start = startIdx;
+        goal = goalIdx;
+
+        RadixHeapQueue<int> pq;
+        pq.reset(grid.size());
+        pq.push(estimate(grid, startIdx), startIdx);
+        rec.push(pq.size());
+
+        while (!pq.empty())
+        {
+            auto [f, u] = pq.pop();
+            rec.pop();
+            int d = store.get(u);
+            if (f > d + estimate(grid, u)) { rec.stale(); continue; }
+            if (u == goalIdx) break;
+
+            forEachSuccessor(grid, u, [&](int v)
+            {
+                int nd = d + octile(grid, u, v);
+                if (nd < store.get(v))
+                {
+                    store.template set<Neighborhood8>(v, nd, u, 0);
+                    rec.relax();
+                    pq.push(nd + estimate(grid, v), v);
+                    rec.push(pq.size());
+                }
+            });
+        }
+        rec.finish();
+
+        lastCost = store.reached(goalIdx) ? store.get(goalIdx) : -1;
+        return buildPath(grid, goalIdx, path);
+    }
+
+    long long cost() const { return lastCost; }
+    std::size_t bytes() const { return store.bytes() + jumps.bytes(); }
+
+private:
+    template<class G>
+    int estimate(const G& grid, int u) const
+    {
+        return heuristic.template estimate<Neighborhood8, int>(grid, u);
+    }
+
+    template<class G>
+    static int octile(const G& grid, int a, int b)
+    {
+        int ddx = std::abs(grid.x(a) - grid.x(b)), ddy = std::abs(grid.y(a) - grid.y(b));
+        int lo = std::min(ddx, ddy), hi = std::max(ddx, ddy);
+        return lo * Neighborhood8::diagonal<int>() + (hi - lo) * Neighborhood8::straight<int>();
+    }
+
+    // Pruned directions out of u given the direction it was entered from;
+    // all eight legal moves at the start.
+    template<class G, class F>
+    void forEachSuccessor(const G& grid, int u, F&& f) const
+    {
+        int x = grid.x(u), y = grid.y(u);
+        auto tryDir = [&](int dx, int dy)
+        {
+            if (bounds && !bounds->allows(grid, u, jpsDirection(dx, dy), goal)) return;
+            int v = jumps.jump(grid, x, y, dx, dy, goal);
+            if (v >= 0) f(v);
+        };
+
+        int p = store.prev[u];
+        if (p < 0)
+        {
+            for (int k = 0; k < 8; ++k) tryDir(Neighborhood8::DX[k], Neighborhood8::DY[k]);
+            return;
+        }
+        int dx = (x > grid.x(p)) - (x < grid.x(p)), dy = (y > grid.y(p)) - (y < grid.y(p));
+        if (dx != 0 && dy != 0)
+        {
+            tryDir(dx, 0);
+            tryDir(0, dy);
+            tryDir(dx, dy);
+        }
+        else if (dx != 0)
+        {
+            tryDir(dx, 0);
+            for (int side : { -1, 1 })
+                if (jpsWalkable(grid, x, y + side))
+                {
+                    tryDir(0, side);
+                    tryDir(dx, side);
+                }
+        }
+        else
+        {
+            tryDir(0, dy);
+            for (int side : { -1, 1 })
+                if (jpsWalkable(grid, x + side, y))
+                {
+                    tryDir(side, 0);
+                    tryDir(side, dy);
+                }
+        }
+    }
+
+    template<class G>
+    bool buildPath(const G& grid, int goalIdx, std::vector<int>& path) const
+    {
+        path.clear();
+        if (!store.reached(goalIdx)) return false;
+        for (int v = goalIdx; store.prev[v] >= 0; v = store.prev[v])
+        {
+            int p = store.prev[v];
+            int x = grid.x(v), y = grid.y(v);
+            int dx = (grid.x(p) > x) - (grid.x(p) < x), dy = (grid.y(p) > y) - (grid.y(p) < y);
+            for (int c = v; c != p; x += dx, y += dy, c = grid.idx(x, y))
+                path.push_back(c);
+        }
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+        return true;
+    }
+
+    FullStorage<int> store;
+    OctileHeuristic heuristic;
+    int start = -1, goal = -1;
+    long long lastCost = -1;
+};
+
+using JumpPointSearch = BasicJumpPointSearch<ScanJumps>;
@@ -0,0 +1,199 @@
+#pragma once
+#include "Jps.hpp"
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+// Jump policy of JPS+: for every cell and each of the eight directions, the
+// number of steps to the next jump point (> 0) or, negated, the number of
+// free steps before a wall (<= 0), so every jump is a single lookup. The goal
+// is caught on the way: straight, if it lies on the ray within reach;
+// diagonal, at the cell where the ray lines up with it.
+//
+// build() fills the table; after a cell toggles, update() recomputes the
+// straight entries of the three rows and columns around it and re-derives
+// only the diagonal entries that change.
+class JumpTable
+{
+public:
+    template<class G>
+    void build(const G& grid)
+    {
+        width = grid.width;
+        height = grid.height;
+        table.assign(std::size_t(grid.size()) * 8, 0);
+        for (int k = 0; k < 8; ++k)
+        {
+            int dx = Neighborhood8::DX[k], dy = Neighborhood8::DY[k];
+            // Each entry reads the one a step ahead, so sweep against (dx, dy).
+            for (int j = 0; j < height; ++j)
+            {
+                int y = dy > 0 ? height - 1 - j : j;
+                for (int i = 0; i < width; ++i)
+                {
+                    int x = dx > 0 ? width - 1 - i : i;
+                    at(grid, x, y, k) = compute(grid, x, y, k);
+                }
+            }
+        }
+        hash = wallHash(grid);
+    }
+
+    template<class G>
+    void update(const G& grid, int cx, int cy)
+    {
+        if (empty()) return;
+        for (int y = std::max(0, cy - 1); y <= std::min(height - 1, cy + 1); ++y)
+            for (int k = 0; k < 2; ++k)
+                for (int i = 0; i < width; ++i)
+                {
+                    int x = Neighborhood8::DX[k] > 0 ? width - 1 - i : i;
+                    at(grid, x, y, k) = compute(grid, x, y, k);
+                }
+        for (int x = std::max(0, cx - 1); x <= std::min(width - 1, cx + 1); ++x)
+            for (int k = 2; k < 4; ++k)
+                for (int j = 0; j < height; ++j)
+                {
+                    int y = Neighborhood8::DY[k] > 0 ? height - 1 - j : j;
+                    at(grid, x, y, k) = compute(grid, x, y, k);
+                }
+
+        // A diagonal entry depends on the cell a step ahead: recompute the
+        // band, then walk back along the ray while entries keep changing.
+        std::deque<std::pair<int, int>> work;
+        for (int y = std::max(0, cy - 1); y <= std::min(height - 1, cy + 1); ++y)
+            for (int x = 0; x < width; ++x) work.push_back({ x, y });
+        for (int x = std::max(0, cx - 1); x <= std::min(width - 1, cx + 1); ++x)
+            for (int y = 0; y < height; ++y) work.push_back({ x, y });
+        for (int k = 4; k < 8; ++k)
+        {
+            int dx = Neighborhood8::DX[k], dy = Neighborhood8::DY[k];
+            std::deque<std::pair<int, int>> queue;
+            for (auto [x, y] : work)
+            {
+                queue.push_back({ x, y });
+                queue.push_back({ x - dx, y - dy });
+            }
+            while (!queue.empty())
+            {
+                auto [x, y] = queue.front();
+                queue.pop_front();
+                if (!grid.inside(x, y)) continue;
+                std::int16_t v = compute(grid, x, y, k);
+                if (v == at(grid, x, y, k)) continue;
+                at(grid, x, y, k) = v;
+                queue.push_back({ x - dx, y - dy });
+            }
+        }
+        hash = wallHash(grid);
+    }
+
+    template<class G>
+    int jump(const G& grid, int x, int y, int dx, int dy, int goal) const
+    {
+        int k = jpsDirection(dx, dy);
+        int d = table[std::size_t(grid.idx(x, y)) * 8 + k];
+        int reach = std::abs(d);
+        int gx = grid.x(goal), gy = grid.y(goal);
+        int ox = gx - x, oy = gy - y;
+        if (dx == 0 || dy == 0)
+        {
+            int along = dx != 0 ? ox * dx : oy * dy, across = dx != 0 ? oy : ox;
+            if (across == 0 && along > 0 && along <= reach) return goal;
+        }
+        else if (ox * dx > 0 && oy * dy > 0)
+        {
+            int m = std::min(ox * dx, oy * dy);
+            if (m <= reach) return grid.idx(x + m * dx, y + m * dy);
+        }
+        return d > 0 ? grid.idx(x + d * dx, y + d * dy) : -1;
+    }
+
+    bool empty() const { return table.empty(); }
+    bool matches(int w, int h) const { return width == w && height == h; }
+    std::size_t bytes() const { return table.capacity() * sizeof(std::int16_t); }
+
+    // Binary file: "JPP1", width, height, slots and a hash of the walls as
+    // int32, then the table. Saved next to the map it was built for.
+    bool save(const std::string& file) const
+    {
+        std::ofstream out(file, std::ios::binary);
+        if (!out) return false;
+        std::int32_t header[4] = { width, height, std::int32_t(table.size() / 8), std::int32_t(hash) };
+        out.write("JPP1", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(std::int16_t));
+        return bool(out);
+    }
+
+    // Fails, leaving the table untouched, unless the file was written for
+    // exactly these walls.
+    template<class G>
+    bool load(const G& grid, const std::string& file)
+    {
+        std::ifstream in(file, std::ios::binary);
+        char magic[4];
+        std::int32_t header[4];
+        if (!in.read(magic, 4) || std::memcmp(magic, "JPP1", 4) != 0) return false;
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+        if (header[0] != grid.width || header[1] != grid.height || header[2] != grid.size() ||
+            std::uint32_t(header[3]) != wallHash(grid))
+            return false;
+        std::vector<std::int16_t> t(std::size_t(header[2]) * 8);
+        if (!in.read(reinterpret_cast<char*>(t.data()), t.size() * sizeof(std::int16_t))) return false;
+        table = std::move(t);
+        width = header[0];
+        height = header[1];
+        hash = std::uint32_t(header[3]);
+        return true;
+    }
+
+private:
+    template<class G>
+    std::int16_t& at(const G& grid, int x, int y, int k)
+    {
+        return table[std::size_t(grid.idx(x, y)) * 8 + k];
+    }
+
+    template<class G>
+    std::int16_t at(const G& grid, int x, int y, int k) const
+    {
+        return table[std::size_t(grid.idx(x, y)) * 8 + k];
+    }
+
+    // Entry for (x, y) in direction k from the entry one step ahead.
+    template<class G>
+    std::int16_t compute(const G& grid, int x, int y, int k) const
+    {
+        int dx = Neighborhood8::DX[k], dy = Neighborhood8::DY[k];
+        int nx = x + dx, ny = y + dy;
+        if (!jpsWalkable(grid, x, y) || !jpsWalkable(grid, nx, ny)) return 0;
+        bool jumpPoint;
+        if (k < 4)
+        {
+            jumpPoint = dx != 0
+                ? (jpsWalkable(grid, nx, ny - 1) && !jpsWalkable(grid, x, ny - 1)) ||
+                  (jpsWalkable(grid, nx, ny + 1) && !jpsWalkable(grid, x, ny + 1))
+                : (jpsWalkable(grid, nx - 1, ny) && !jpsWalkable(grid, nx - 1, y)) ||
+                  (jpsWalkable(grid, nx + 1, ny) && !jpsWalkable(grid, nx + 1, y));
+        }
+        else
+        {
+            if (!jpsWalkable(grid, nx, y) || !jpsWalkable(grid, x, ny)) return 0;
+            jumpPoint = at(grid, nx, ny, jpsDirection(dx, 0)) > 0 || at(grid, nx, ny, jpsDirection(0, dy)) > 0;
+        }
+        if (jumpPoint) return 1;
+        int ahead = at(grid, nx, ny, k);
+        return std::int16_t(ahead > 0 ? ahead + 1 : ahead - 1);
+    }
+
+    int width = 0, height = 0;
+    std::uint32_t hash = 0;
+    std::vector<std::int16_t> table;  // [slot * 8 + direction]
+};
+
+using JpsPlus = BasicJumpPointSearch<JumpTable>;
@@ -0,0 +1,106 @@
+#pragma once
+#include "Search.hpp"
+#include <vector>
+#include <random>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+// ALT landmarks by farthest-point selection: the first landmark is the cell
+// farthest from a random floor cell, each next one the cell whose nearest
+// landmark is farthest away. The flood from each landmark is its table, so
+// selection costs one flood per landmark plus the seed flood. Landmarks stay
+// in the seed's component; other components get INF and a zero bound.
+template<class Neighborhood, class Dist, class G>
+LandmarkHeuristic<Dist> selectLandmarks(const G& grid, int count, unsigned seed = 1u)
+{
+    LandmarkHeuristic<Dist> lh;
+    FullStorage<Dist> store;
+    SearchStats stats;
+    ZeroHeuristic zero;
+    auto flood = [&](int from)
+    {
+        search<Neighborhood, ZeroHeuristic, BinaryHeapQueue<Dist>, FullStorage<Dist>>(
+            grid, from, -1, store, stats, zero);
+    };
+    auto farthest = [&](const std::vector<Dist>& d)
+    {
+        int best = -1;
+        for (int v = 0; v < int(d.size()); ++v)
+            if (d[v] != distInf<Dist>() && (best < 0 || d[v] > d[best])) best = v;
+        return best;
+    };
+
+    std::vector<int> floor;
+    for (int v = 0; v < grid.size(); ++v)
+        if (grid[v] != 1) floor.push_back(v);
+    if (floor.empty() || count <= 0) return lh;
+    std::mt19937 rng(seed);
+    flood(floor[rng() % floor.size()]);
+
+    std::vector<Dist> nearest = store.dist;
+    int next = farthest(nearest);
+    while (int(lh.cells.size()) < count && next >= 0 && (lh.cells.empty() || nearest[next] > Dist(0)))
+    {
+        flood(next);
+        lh.cells.push_back(next);
+        lh.tables.push_back(store.dist);
+        for (int v = 0; v < grid.size(); ++v)
+            if (lh.cells.size() == 1 || store.dist[v] < nearest[v]) nearest[v] = store.dist[v];
+        next = farthest(nearest);
+    }
+    return lh;
+}
+
+// Binary table file: "ALT2", width, height, slots, landmark count, a
+// distance type tag and a hash of grid's walls as int32, then the landmark
+// slots and the raw tables. Save against the grid the tables were built on.
+template<class Dist>
+constexpr std::int32_t landmarkTypeTag()
+{
+    return std::int32_t(sizeof(Dist)) | (std::is_floating_point<Dist>::value ? 0x100 : 0) |
+           (std::is_signed<Dist>::value ? 0x200 : 0);
+}
+
+template<class Dist, class G>
+bool saveLandmarks(const LandmarkHeuristic<Dist>& lh, const G& grid, const std::string& file)
+{
+    std::ofstream out(file, std::ios::binary);
+    if (!out) return false;
+    std::int32_t header[6] = { grid.width, grid.height, grid.size(), std::int32_t(lh.cells.size()),
+                               landmarkTypeTag<Dist>(), std::int32_t(wallHash(grid)) };
+    out.write("ALT2", 4);
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(lh.cells.data()), lh.cells.size() * sizeof(int));
+    for (const auto& t : lh.tables)
+        out.write(reinterpret_cast<const char*>(t.data()), t.size() * sizeof(Dist));
+    return bool(out);
+}
+
+// Fails, leaving lh untouched, when the file is missing, truncated or was
+// written for a grid of another shape, other walls or another distance type.
+template<class Dist, class G>
+bool loadLandmarks(LandmarkHeuristic<Dist>& lh, const G& grid, const std::string& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    char magic[4];
+    std::int32_t header[6];
+    if (!in.read(magic, 4) || std::memcmp(magic, "ALT2", 4) != 0) return false;
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    if (header[0] != grid.width || header[1] != grid.height || header[2] != grid.size() ||
+        header[3] < 0 || header[4] != landmarkTypeTag<Dist>() || std::uint32_t(header[5]) != wallHash(grid))
+        return false;
+
+    LandmarkHeuristic<Dist> loaded;
+    loaded.cells.resize(header[3]);
+    loaded.tables.assign(header[3], std::vector<Dist>(grid.size()));
+    in.read(reinterpret_cast<char*>(loaded.cells.data()), loaded.cells.size() * sizeof(int));
+    for (auto& t : loaded.tables)
+        in.read(reinterpret_cast<char*>(t.data()), t.size() * sizeof(Dist));
+    if (!in) return false;
+    lh = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <algorithm>
+
+// Line of sight between cell centres over packed wall bits. Walls are kept
+// twice, row-major and column-major (bit b of word w is coordinate 64w + b).
+// A shallow line crosses few rows, each over a long run of cells, so it is
+// checked row by row with one masked word test per 64 cells; a steep line is
+// checked the same way over the columns.
+//
+// Every cell the segment touches must be free, boundaries included, so a
+// line may not squeeze between walls that meet at a corner; for adjacent
+// cells this is the diagonal rule of MaskedNeighborhood8.
+class LineOfSight
+{
+public:
+    template<class G>
+    void load(const G& grid)
+    {
+        width = grid.width;
+        height = grid.height;
+        rowWords = (width + 63) / 64;
+        colWords = (height + 63) / 64;
+        rows.assign(std::size_t(rowWords) * height, 0);
+        cols.assign(std::size_t(colWords) * width, 0);
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                if (grid[grid.idx(x, y)] == 1) set(x, y, true);
+    }
+
+    void set(int x, int y, bool wall)
+    {
+        std::uint64_t& r = rows[std::size_t(y) * rowWords + (x >> 6)];
+        std::uint64_t& c = cols[std::size_t(x) * colWords + (y >> 6)];
+        std::uint64_t rb = std::uint64_t(1) << (x & 63), cb = std::uint64_t(1) << (y & 63);
+        r = wall ? r | rb : r & ~rb;
+        c = wall ? c | cb : c & ~cb;
+    }
+
+    bool clear(int ax, int ay, int bx, int by) const
+    {
+        if (std::abs(bx - ax) >= std::abs(by - ay)) return sweep(rows, rowWords, ax, ay, bx, by);
+        return sweep(cols, colWords, ay, ax, by, bx);
+    }
+
+    bool empty() const { return rows.empty(); }
+    bool matches(int w, int h) const { return width == w && height == h; }
+    std::size_t bytes() const { return (rows.capacity() + cols.capacity()) * sizeof(std::uint64_t); }
+
+private:
+    static long long floorDiv(long long a, long long b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    // Lines are the major axis (rows for a shallow segment); positions run
+    // along them. Works in doubled coordinates, where the centre of cell c is
+    // 2c + 1 and line l spans [2l, 2l + 2].
+    static bool sweep(const std::vector<std::uint64_t>& bits, int words, int ap, int al, int bp, int bl)
+    {
+        if (al > bl)
+        {
+            std::swap(ap, bp);
+            std::swap(al, bl);
+        }
+        long long P0 = 2 * ap + 1, L0 = 2 * al + 1, dP = 2 * (bp - ap), dL = 2 * (bl - al);
+        for (int l = al; l <= bl; ++l)
+        {
+            int lo, hi;
+            if (dL == 0)
+            {
+                lo = std::min(ap, bp);
+                hi = std::max(ap, bp);
+            }
+            else
+            {
+                // Position along the segment is num / dL at line coordinate L.
+                long long La = std::max<long long>(2 * l, L0), Lb = std::min<long long>(2 * l + 2, L0 + dL);
+                long long na = P0 * dL + (La - L0) * dP, nb = P0 * dL + (Lb - L0) * dP;
+                long long nmin = std::min(na, nb), nmax = std::max(na, nb);
+                lo = int(-floorDiv(-nmin, 2 * dL) - 1);
+                hi = int(floorDiv(nmax, 2 * dL));
+            }
+            if (blocked(&bits[std::size_t(l) * words], lo, hi)) return false;
+        }
+        return true;
+    }
+
+    // Any wall bit among positions lo..hi of one line.
+    static bool blocked(const std::uint64_t* line, int lo, int hi)
+    {
+        int w0 = lo >> 6, w1 = hi >> 6;
+        std::uint64_t first = ~std::uint64_t(0) << (lo & 63);
+        std::uint64_t last = ~std::uint64_t(0) >> (63 - (hi & 63));
+        if (w0 == w1) return (line[w0] & first & last) != 0;
+        if (line[w0] & first) return true;
+        for (int w = w0 + 1; w < w1; ++w)
+            if (line[w]) return true;
+        return (line[w1] & last) != 0;
+    }
+
+    int width = 0, height = 0, rowWords = 0, colWords = 0;
+    std::vector<std::uint64_t> rows, cols;  // wall bits
+};
+
+// Appends the cells after a up to b that the centre-to-centre segment passes
+// through, 4-connected; where it crosses a corner exactly the horizontal
+// neighbour is taken first. All of them are free when the segment is clear.
+template<class G>
+void appendSegmentCells(const G& grid, int a, int b, std::vector<int>& path)
+{
+    int x = grid.x(a), y = grid.y(a);
+    int nx = std::abs(grid.x(b) - x), ny = std::abs(grid.y(b) - y);
+    int sx = grid.x(b) > x ? 1 : -1, sy = grid.y(b) > y ? 1 : -1;
+    for (int ix = 0, iy = 0; ix < nx || iy < ny;)
+    {
+        long long d = (1 + 2LL * ix) * ny - (1 + 2LL * iy) * nx;
+        if (d <= 0)
+        {
+            x += sx;
+            ++ix;
+        }
+        else
+        {
+            y += sy;
+            ++iy;
+        }
+        path.push_back(grid.idx(x, y));
+    }
+}
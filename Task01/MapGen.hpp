@@ -0,0 +1,95 @@
+#pragma once
+#include "Grid.hpp"
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+// Reproducible map families for the headless runner and the benchmarks.
+enum class MapFamily { Random, Maze, Rooms, Open };
+
+static constexpr const char* MAP_FAMILY_NAMES[] = { "random", "maze", "rooms", "open" };
+
+inline Grid makeMap(MapFamily family, int width, int height, unsigned seed)
+{
+    Grid grid(width, height);
+    std::mt19937 rng(seed);
+    auto coin = [&](int n) { return int(rng() % unsigned(n)); };
+
+    switch (family)
+    {
+    case MapFamily::Random:
+    case MapFamily::Open:
+    {
+        int walls = family == MapFamily::Random ? width * height / 3 : width * height / 20;
+        for (int i = 0; i < walls; ++i)
+            grid[grid.idx(coin(width), coin(height))] = 1;
+        break;
+    }
+    case MapFamily::Maze:
+    {
+        // Recursive backtracker on odd cells; corridors are one cell wide.
+        std::fill(grid.cells.begin(), grid.cells.end(), 1);
+        std::vector<std::pair<int, int>> stack{ { 1, 1 } };
+        grid[grid.idx(1, 1)] = 0;
+        while (!stack.empty())
+        {
+            auto [x, y] = stack.back();
+            int order[4] = { 0, 1, 2, 3 };
+            std::shuffle(order, order + 4, rng);
+            bool moved = false;
+            for (int k : order)
+            {
+                int nx = x + 2 * dx[k], ny = y + 2 * dy[k];
+                if (nx < 1 || ny < 1 || nx >= width - 1 || ny >= height - 1) continue;
+                if (grid[grid.idx(nx, ny)] == 0) continue;
+                grid[grid.idx(x + dx[k], y + dy[k])] = 0;
+                grid[grid.idx(nx, ny)] = 0;
+                stack.emplace_back(nx, ny);
+                moved = true;
+                break;
+            }
+            if (!moved) stack.pop_back();
+        }
+        break;
+    }
+    case MapFamily::Rooms:
+    {
+        // Square rooms separated by walls with a door in every side.
+        const int room = 16;
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                if (x % room == 0 || y % room == 0)
+                    grid[grid.idx(x, y)] = 1;
+        for (int y = 0; y < height; y += room)
+            for (int x = 0; x < width; x += room)
+            {
+                int doorX = x + 1 + coin(room - 1), doorY = y + 1 + coin(room - 1);
+                if (y > 0 && doorX < width) grid[grid.idx(doorX, y)] = 0;
+                if (x > 0 && doorY < height) grid[grid.idx(x, doorY)] = 0;
+            }
+        break;
+    }
+    }
+    return grid;
+}
+
+inline Grid makeMap(MapFamily family, int size, unsigned seed)
+{
+    return makeMap(family, size, size, seed);
+}
+
+// Random pairs of floor cells, fixed by the seed.
+inline std::vector<std::pair<int, int>> makeQueries(const Grid& grid, int count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<int> floor;
+    for (int i = 0; i < grid.size(); ++i)
+        if (grid[i] == 0) floor.push_back(i);
+
+    std::vector<std::pair<int, int>> queries;
+    if (floor.empty()) return queries;
+    for (int q = 0; q < count; ++q)
+        queries.emplace_back(floor[rng() % floor.size()], floor[rng() % floor.size()]);
+    return queries;
+}
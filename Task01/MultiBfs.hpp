@@ -0,0 +1,179 @@
+#pragma once
+#include "Grid.hpp"
+#include "Bits.hpp"
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+// Multi-source BFS for unit-cost 4-connected maps: up to 64 sources share
+// one sweep, each cell holding a bit per source that has reached it, so one
+// pass advances every source by a layer.
+class MultiSourceBfs
+{
+public:
+    static constexpr int BATCH = 64;
+
+    // One distance field per source, indexed by grid slots, INF where unreachable.
+    template<class G>
+    void fields(const G& grid, const std::vector<int>& sources, std::vector<std::vector<int>>& dist)
+    {
+        dist.resize(sources.size());
+        for (std::size_t b = 0; b < sources.size(); b += BATCH)
+        {
+            int count = int(std::min<std::size_t>(BATCH, sources.size() - b));
+            for (int i = 0; i < count; ++i) dist[b + i].assign(grid.size(), INF);
+            sweep(grid, &sources[b], count, [&](std::uint64_t bits, int v, int layer)
+            {
+                for (; bits; bits &= bits - 1)
+                    dist[b + lowestBit(bits)][v] = layer;
+                return true;
+            });
+        }
+    }
+
+    // Distance of each (start, goal) pair, INF if unreachable. Queries are
+    // batched by start and a batch stops once all of its goals are reached.
+    template<class G>
+    void queries(const G& grid, const std::vector<std::pair<int, int>>& pairs, std::vector<int>& dist)
+    {
+        dist.assign(pairs.size(), INF);
+        std::vector<int> order(pairs.size());
+        for (std::size_t i = 0; i < order.size(); ++i) order[i] = int(i);
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return pairs[a].first < pairs[b].first; });
+
+        want.assign(grid.size(), 0);
+        std::vector<int> sources, goals;
+        std::vector<std::vector<int>> askers;
+        for (std::size_t q = 0; q < order.size();)
+        {
+            sources.clear();
+            askers.clear();
+            goals.clear();
+            while (q < order.size() && (int(sources.size()) < BATCH || sources.back() == pairs[order[q]].first))
+            {
+                auto [s, g] = pairs[order[q]];
+                if (sources.empty() || sources.back() != s)
+                {
+                    sources.push_back(s);
+                    askers.emplace_back();
+                }
+                int bit = int(sources.size()) - 1;
+                askers.back().push_back(order[q]);
+                want[g] |= std::uint64_t(1) << bit;
+                goals.push_back(g);
+                ++q;
+            }
+
+            std::size_t pending = goals.size();
+            sweep(grid, sources.data(), int(sources.size()), [&](std::uint64_t bits, int v, int layer)
+            {
+                for (std::uint64_t hit = bits & want[v]; hit; hit &= hit - 1)
+                    for (int qi : askers[lowestBit(hit)])
+                        if (pairs[qi].second == v && dist[qi] == INF)
+                        {
+                            dist[qi] = layer;
+                            --pending;
+                        }
+                return pending > 0;
+            });
+            for (int g : goals) want[g] = 0;
+        }
+    }
+
+    std::size_t bytes() const
+    {
+        return (seen.capacity() + visit.capacity() + visitNext.capacity() + want.capacity()) * sizeof(std::uint64_t) +
+               (frontier.capacity() + nextFrontier.capacity() + slots.capacity()) * sizeof(int);
+    }
+
+private:
+    // Padded row-major copy: the border is a ring of walls, so neighbours need
+    // no bounds checks. Each layer either sweeps the rows around the frontier
+    // densely (OR of four neighbours per cell) or, while the frontier is thin
+    // relative to that band, pushes bits out of the frontier list.
+    // reach(bits, v, layer) gets the sources that first reach slot v at this
+    // layer; returning false ends the sweep.
+    template<class G, class F>
+    void sweep(const G& grid, const int* sources, int count, F&& reach)
+    {
+        int pitch = grid.width + 2;
+        std::size_t cells = std::size_t(pitch) * (grid.height + 2);
+        seen.assign(cells, ~std::uint64_t(0));
+        visit.assign(cells, 0);
+        visitNext.assign(cells, 0);
+        slots.assign(cells, -1);
+        for (int y = 0; y < grid.height; ++y)
+            for (int x = 0; x < grid.width; ++x)
+            {
+                std::size_t c = std::size_t(y + 1) * pitch + x + 1;
+                slots[c] = grid.idx(x, y);
+                if (grid[slots[c]] != 1) seen[c] = 0;
+            }
+
+        frontier.clear();
+        for (int i = 0; i < count; ++i)
+        {
+            int c = (grid.y(sources[i]) + 1) * pitch + grid.x(sources[i]) + 1;
+            if (!visit[c]) frontier.push_back(c);
+            visit[c] |= std::uint64_t(1) << i;
+            seen[c] |= std::uint64_t(1) << i;
+        }
+        for (int c : frontier)
+            if (!reach(visit[c], slots[c], 0)) return;
+
+        for (int layer = 1; !frontier.empty(); ++layer)
+        {
+            auto [first, last] = std::minmax_element(frontier.begin(), frontier.end());
+            int from = std::max(*first / pitch - 1, 1), to = std::min(*last / pitch + 1, grid.height);
+            nextFrontier.clear();
+            if (frontier.size() * 16 >= std::size_t(to - from + 1) * grid.width)
+            {
+                for (int y = from; y <= to; ++y)
+                {
+                    std::size_t row = std::size_t(y) * pitch;
+                    const std::uint64_t* v = &visit[row];
+                    std::uint64_t* n = &visitNext[row];
+                    std::uint64_t* sn = &seen[row];
+                    std::uint64_t any = 0;
+                    for (int x = 1; x <= grid.width; ++x)
+                    {
+                        std::uint64_t f = (v[x - 1] | v[x + 1] | v[x - pitch] | v[x + pitch]) & ~sn[x];
+                        n[x] = f;
+                        any |= f;
+                    }
+                    if (any)
+                        for (int x = 1; x <= grid.width; ++x)
+                            if (n[x]) nextFrontier.push_back(int(row) + x);
+                }
+            }
+            else
+            {
+                const int step[4] = { 1, -1, pitch, -pitch };
+                for (int u : frontier)
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        int v = u + step[k];
+                        std::uint64_t add = visit[u] & ~seen[v];
+                        if (!add) continue;
+                        if (!visitNext[v]) nextFrontier.push_back(v);
+                        visitNext[v] |= add;
+                    }
+            }
+
+            for (int u : frontier) visit[u] = 0;
+            visit.swap(visitNext);
+            frontier.swap(nextFrontier);
+            bool more = true;
+            for (int c : frontier)
+            {
+                seen[c] |= visit[c];
+                if (more) more = reach(visit[c], slots[c], layer);
+            }
+            if (!more) return;
+        }
+    }
+
+    std::vector<std::uint64_t> seen, visit, visitNext, want;
+    std::vector<int> frontier, nextFrontier, slots;
+};
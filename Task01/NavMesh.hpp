@@ -0,0 +1,245 @@
+#pragma once
+#include "Rsr.hpp"
+#include "Search.hpp"
+#include "Waypoints.hpp"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Navigation mesh over the free cells: the empty rectangles of the symmetry
+// reduction are its convex polygons and the edges two rectangles share are
+// its portals. A query runs A* over rectangles, costing each step between
+// portal midpoints, then pulls a taut polyline through the portals of the
+// route with the funnel algorithm. The cell path it also returns walks the
+// same rectangles, so grid code keeps working.
+//
+// update() remeshes only the rectangles around an edited cell.
+class NavMesh
+{
+public:
+    template<class G>
+    void build(const G& grid) { regions.build(grid); }
+
+    template<class G>
+    void update(const G& grid, int cx, int cy) { regions.update(grid, cx, cy); }
+
+    template<bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        path.clear();
+        line.clear();
+        lastCost = -1;
+        int from = regions.room(startIdx), to = regions.room(goalIdx);
+        if (from < 0 || to < 0) { rec.finish(); return false; }
+        Waypoint start = cellCentre(grid, startIdx), goal = cellCentre(grid, goalIdx);
+
+        int n = regions.ids();
+        dist.assign(n, INFINITY);
+        parent.assign(n, -1);
+        entry.resize(n);
+        BinaryHeapQueue<float> pq;
+        pq.reset(n);
+        dist[from] = 0.f;
+        entry[from] = start;
+        pq.push(distance(start, goal), from);
+        rec.push(pq.size());
+        while (!pq.empty())
+        {
+            auto [f, u] = pq.pop();
+            rec.pop();
+            if (f > dist[u] + distance(entry[u], goal)) { rec.stale(); continue; }
+            if (u == to) break;
+            forEachPortal(grid, u, [&](int v, Waypoint a, Waypoint b)
+            {
+                Waypoint mid{ (a.x + b.x) / 2, (a.y + b.y) / 2 };
+                float nd = dist[u] + distance(entry[u], mid);
+                if (nd >= dist[v]) return;
+                dist[v] = nd;
+                parent[v] = u;
+                entry[v] = mid;
+                rec.relax();
+                pq.push(nd + distance(mid, goal), v);
+                rec.push(pq.size());
+            });
+        }
+        rec.finish();
+        if (dist[to] == INFINITY) return false;
+
+        route.clear();
+        for (int r = to; r >= 0; r = parent[r]) route.push_back(r);
+        std::reverse(route.begin(), route.end());
+        funnel(start, goal);
+        walkCells(grid, startIdx, goalIdx, path);
+        lastCost = std::lround(polylineLength(line) * 10.f);
+        return true;
+    }
+
+    // Corners of the last path, start and goal cell centres included.
+    const std::vector<Waypoint>& polyline() const { return line; }
+
+    long long cost() const { return lastCost; }  // polyline length in tenths of a cell
+    int polygons() const { return regions.count(); }
+    int routeLength() const { return int(route.size()); }
+    bool empty() const { return regions.empty(); }
+    bool matches(int w, int h) const { return regions.matches(w, h); }
+
+    std::size_t bytes() const
+    {
+        return regions.bytes() + (dist.capacity() + entry.capacity() * 2) * sizeof(float) +
+               (parent.capacity() + route.capacity()) * sizeof(int) +
+               (portals.capacity() * 2 + line.capacity()) * sizeof(Waypoint);
+    }
+
+private:
+    struct Portal
+    {
+        Waypoint left, right;
+    };
+
+    // f(v, a, b) for every rectangle v sharing an edge with u, a..b being
+    // the shared stretch of that edge.
+    template<class G, class F>
+    void forEachPortal(const G& grid, int u, F&& f) const
+    {
+        const EmptyRectangles::Rect& r = regions.rect(u);
+        auto scan = [&](int x, int y, int dx, int dy, int count, float edge)
+        {
+            for (int i = 0; i < count;)
+            {
+                int cx = x + i * dx, cy = y + i * dy;
+                int v = grid.inside(cx, cy) ? regions.room(grid.idx(cx, cy)) : -1;
+                if (v < 0) { ++i; continue; }
+                const EmptyRectangles::Rect& o = regions.rect(v);
+                int last = dx != 0 ? std::min(o.x1 - x, count - 1) : std::min(o.y1 - y, count - 1);
+                if (dx != 0) f(v, Waypoint{ float(cx), edge }, Waypoint{ float(x + last + 1), edge });
+                else f(v, Waypoint{ edge, float(cy) }, Waypoint{ edge, float(y + last + 1) });
+                i = last + 1;
+            }
+        };
+        int w = r.x1 - r.x0 + 1, h = r.y1 - r.y0 + 1;
+        scan(r.x0 - 1, r.y0, 0, 1, h, float(r.x0));
+        scan(r.x1 + 1, r.y0, 0, 1, h, float(r.x1 + 1));
+        scan(r.x0, r.y0 - 1, 1, 0, w, float(r.y0));
+        scan(r.x0, r.y1 + 1, 1, 0, w, float(r.y1 + 1));
+    }
+
+    // Portal from rectangle a into b, its ends named as seen walking across.
+    Portal portalBetween(int a, int b) const
+    {
+        const EmptyRectangles::Rect& p = regions.rect(a);
+        const EmptyRectangles::Rect& q = regions.rect(b);
+        if (q.x1 < p.x0 || q.x0 > p.x1)
+        {
+            float x = float(q.x1 < p.x0 ? p.x0 : p.x1 + 1);
+            Waypoint lo{ x, float(std::max(p.y0, q.y0)) }, hi{ x, float(std::min(p.y1, q.y1) + 1) };
+            return q.x0 > p.x1 ? Portal{ hi, lo } : Portal{ lo, hi };
+        }
+        float y = float(q.y1 < p.y0 ? p.y0 : p.y1 + 1);
+        Waypoint lo{ float(std::max(p.x0, q.x0)), y }, hi{ float(std::min(p.x1, q.x1) + 1), y };
+        return q.y0 > p.y1 ? Portal{ lo, hi } : Portal{ hi, lo };
+    }
+
+    // Twice the signed area of (a, b, c); its sign tells which side of a->b
+    // c lies on.
+    static float area2(const Waypoint& a, const Waypoint& b, const Waypoint& c)
+    {
+        return (c.x - a.x) * (b.y - a.y) - (b.x - a.x) * (c.y - a.y);
+    }
+
+    static bool same(const Waypoint& a, const Waypoint& b) { return a.x == b.x && a.y == b.y; }
+
+    // Simple stupid funnel: keep the apex and the two funnel sides, tighten
+    // them portal by portal, and emit a corner whenever one side crosses the
+    // other.
+    void funnel(const Waypoint& start, const Waypoint& goal)
+    {
+        portals.clear();
+        portals.push_back(Portal{ start, start });
+        for (std::size_t i = 1; i < route.size(); ++i) portals.push_back(portalBetween(route[i - 1], route[i]));
+        portals.push_back(Portal{ goal, goal });
+
+        line.push_back(start);
+        Waypoint apex = start, left = start, right = start;
+        int apexAt = 0, leftAt = 0, rightAt = 0;
+        for (int i = 1; i < int(portals.size()); ++i)
+        {
+            const Waypoint& l = portals[i].left;
+            const Waypoint& r = portals[i].right;
+            if (area2(apex, right, r) <= 0.f)
+            {
+                if (same(apex, right) || area2(apex, left, r) > 0.f)
+                {
+                    right = r;
+                    rightAt = i;
+                }
+                else
+                {
+                    line.push_back(left);
+                    apex = right = left;
+                    apexAt = rightAt = leftAt;
+                    i = apexAt;
+                    continue;
+                }
+            }
+            if (area2(apex, left, l) >= 0.f)
+            {
+                if (same(apex, left) || area2(apex, right, l) < 0.f)
+                {
+                    left = l;
+                    leftAt = i;
+                }
+                else
+                {
+                    line.push_back(right);
+                    apex = left = right;
+                    apexAt = leftAt = rightAt;
+                    i = apexAt;
+                    continue;
+                }
+            }
+        }
+        if (!same(line.back(), goal)) line.push_back(goal);
+    }
+
+    // Cells along the route: straight through each rectangle to the nearest
+    // cell of the edge shared with the next one, then across.
+    template<class G>
+    void walkCells(const G& grid, int startIdx, int goalIdx, std::vector<int>& path) const
+    {
+        int x = grid.x(startIdx), y = grid.y(startIdx);
+        path.push_back(startIdx);
+        auto walk = [&](int tx, int ty)
+        {
+            for (; x != tx; x += tx > x ? 1 : -1) path.push_back(grid.idx(x + (tx > x ? 1 : -1), y));
+            for (; y != ty; y += ty > y ? 1 : -1) path.push_back(grid.idx(x, y + (ty > y ? 1 : -1)));
+        };
+        for (std::size_t i = 0; i + 1 < route.size(); ++i)
+        {
+            const EmptyRectangles::Rect& a = regions.rect(route[i]);
+            const EmptyRectangles::Rect& b = regions.rect(route[i + 1]);
+            if (b.x1 < a.x0 || b.x0 > a.x1)
+            {
+                int ty = std::clamp(y, std::max(a.y0, b.y0), std::min(a.y1, b.y1));
+                int tx = b.x1 < a.x0 ? a.x0 : a.x1;
+                walk(tx, ty);
+                walk(b.x1 < a.x0 ? tx - 1 : tx + 1, ty);
+            }
+            else
+            {
+                int tx = std::clamp(x, std::max(a.x0, b.x0), std::min(a.x1, b.x1));
+                int ty = b.y1 < a.y0 ? a.y0 : a.y1;
+                walk(tx, ty);
+                walk(tx, b.y1 < a.y0 ? ty - 1 : ty + 1);
+            }
+        }
+        walk(grid.x(goalIdx), grid.y(goalIdx));
+    }
+
+    EmptyRectangles regions;
+    std::vector<float> dist;
+    std::vector<int> parent, route;
+    std::vector<Waypoint> entry, line;
+    std::vector<Portal> portals;
+    long long lastCost = -1;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include "Grid.hpp"
+#include "Bits.hpp"
+#include "SearchPolicies.hpp"
+#include <vector>
+#include <cstdint>
+
+// Grid plus a per-slot byte of passable moves, bit k = Neighborhood8 move k
+// (bits 0-3 orthogonal, 4-7 diagonal without corner cutting). Built once and
+// patched around each edit, so the masked neighborhoods below never touch
+// bounds or neighbouring cells in the inner loop. Edit through set() to keep
+// the masks current.
+template<class G>
+struct MaskedGrid : G
+{
+    std::vector<std::uint8_t> masks;
+
+    MaskedGrid() = default;
+    explicit MaskedGrid(const G& grid) : G(grid) { rebuildMasks(); }
+
+    void rebuildMasks()
+    {
+        masks.assign(this->size(), 0);
+        for (int y = 0; y < this->height; ++y)
+            for (int x = 0; x < this->width; ++x)
+                masks[this->idx(x, y)] = computeMask(x, y);
+    }
+
+    void set(int x, int y, int value)
+    {
+        (*this)[this->idx(x, y)] = value;
+        for (int ny = y - 1; ny <= y + 1; ++ny)
+            for (int nx = x - 1; nx <= x + 1; ++nx)
+                if (this->inside(nx, ny)) masks[this->idx(nx, ny)] = computeMask(nx, ny);
+    }
+
+    std::uint8_t computeMask(int x, int y) const
+    {
+        auto open = [&](int cx, int cy) { return this->inside(cx, cy) && (*this)[this->idx(cx, cy)] != 1; };
+        std::uint8_t m = 0;
+        for (int k = 0; k < 4; ++k)
+            if (open(x + Neighborhood8::DX[k], y + Neighborhood8::DY[k])) m |= std::uint8_t(1 << k);
+        for (int k = 4; k < 8; ++k)
+        {
+            int ox = Neighborhood8::DX[k] > 0 ? 0 : 1, oy = Neighborhood8::DY[k] > 0 ? 2 : 3;
+            if ((m >> ox & 1) && (m >> oy & 1) && open(x + Neighborhood8::DX[k], y + Neighborhood8::DY[k]))
+                m |= std::uint8_t(1 << k);
+        }
+        return m;
+    }
+};
+
+template<class Base, unsigned Bits>
+struct MaskedNeighborhood : Base
+{
+    template<class G, class F>
+    static void forEach(const G& grid, int u, F&& f)
+    {
+        unsigned m = grid.masks[u] & Bits;
+        while (m)
+        {
+            int k = lowestBit(m);
+            m &= m - 1;
+            f(grid.step(u, Base::DX[k], Base::DY[k]), k);
+        }
+    }
+};
+
+using MaskedNeighborhood4 = MaskedNeighborhood<Neighborhood4, 0x0Fu>;
+using MaskedNeighborhood8 = MaskedNeighborhood<Neighborhood8, 0xFFu>;
@@ -0,0 +1,66 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+inline int hardwareThreads()
+{
+    return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+// Reusable barrier; the last thread to arrive runs onComplete before anyone
+// is released, so it can publish shared state for the next phase.
+class Barrier
+{
+public:
+    Barrier(int count, std::function<void()> onComplete = {})
+        : count(count), waiting(0), generation(0), onComplete(std::move(onComplete)) {}
+
+    void arriveAndWait()
+    {
+        std::unique_lock<std::mutex> lock(m);
+        int gen = generation;
+        if (++waiting == count)
+        {
+            if (onComplete) onComplete();
+            waiting = 0;
+            ++generation;
+            cv.notify_all();
+            return;
+        }
+        cv.wait(lock, [&] { return gen != generation; });
+    }
+
+private:
+    std::mutex m;
+    std::condition_variable cv;
+    int count, waiting, generation;
+    std::function<void()> onComplete;
+};
+
+// Runs fn(thread) on `threads` threads, the caller being thread 0.
+template<class F>
+void runThreads(int threads, F&& fn)
+{
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back([&fn, t] { fn(t); });
+    fn(0);
+    for (auto& th : pool) th.join();
+}
+
+// fn(i) for i in [0, count), handed out in chunks from a shared counter so
+// uneven items (one search per source, say) balance across threads.
+template<class F>
+void parallelFor(int count, int threads, F&& fn, int chunk = 1)
+{
+    std::atomic<int> next{ 0 };
+    runThreads(std::min(threads, std::max(count, 1)), [&](int)
+    {
+        for (int begin; (begin = next.fetch_add(chunk)) < count;)
+            for (int i = begin; i < std::min(begin + chunk, count); ++i) fn(i);
+    });
+}
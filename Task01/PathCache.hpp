@@ -0,0 +1,195 @@
+#pragma once
+#include "PathSmoothing.hpp"
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+struct PathCacheStats
+{
+    long long hits = 0, misses = 0;
+    long long onPath = 0;     // entries dropped because an edited cell was on the path
+    long long inRegion = 0;   // exact entries dropped because an opened cell could shorten them
+    long long evicted = 0;    // least recently used entries dropped to stay under maxBytes
+};
+
+// Move costs the exact-entry test bounds distances with, in the engine's own
+// units: 1/2 for 4-connected, 10/14 for 8-connected.
+struct PathUnits
+{
+    int straight = 1, diagonal = 2;
+};
+
+// LRU cache of found paths keyed on (start, goal, engine), each stored
+// run-length encoded. cellChanged() drops exactly the entries an edit can
+// affect: any whose path (or a corner one of its diagonal steps cuts) is the
+// edited cell, and, when the cell opened up, any exact entry for which a
+// route through or past it could be shorter than the cached cost.
+class PathCache
+{
+public:
+    std::size_t maxBytes = std::size_t(1) << 20;
+
+    template<class G>
+    bool lookup(const G& grid, int start, int goal, int engine, std::vector<int>& path, long long& cost)
+    {
+        auto it = index.find(key(grid, start, goal, engine));
+        if (it == index.end())
+        {
+            ++counters.misses;
+            return false;
+        }
+        ++counters.hits;
+        entries.splice(entries.begin(), entries, it->second);
+        decodeRuns(grid, it->second->runs, path);
+        cost = it->second->cost;
+        return true;
+    }
+
+    // exact: cost is optimal, so opening a cell near the path can stale it.
+    template<class G>
+    void store(const G& grid, int start, int goal, int engine, const std::vector<int>& path, long long cost,
+               bool exact, PathUnits units = PathUnits{})
+    {
+        std::uint64_t k = key(grid, start, goal, engine);
+        auto it = index.find(k);
+        if (it != index.end()) drop(it->second);
+
+        Entry e;
+        e.key = k;
+        e.start = start;
+        e.goal = goal;
+        e.cost = cost;
+        e.exact = exact;
+        e.units = units;
+        encodeRuns(grid, path, e.runs);
+        e.runs.runs.shrink_to_fit();
+        e.x0 = e.x1 = grid.x(start);
+        e.y0 = e.y1 = grid.y(start);
+        for (int v : path)
+        {
+            e.x0 = std::min(e.x0, grid.x(v));
+            e.x1 = std::max(e.x1, grid.x(v));
+            e.y0 = std::min(e.y0, grid.y(v));
+            e.y1 = std::max(e.y1, grid.y(v));
+        }
+        entries.push_front(std::move(e));
+        index[k] = entries.begin();
+        used += entryBytes(entries.front());
+        while (used > maxBytes && entries.size() > 1)
+        {
+            drop(std::prev(entries.end()));
+            ++counters.evicted;
+        }
+    }
+
+    // Call after cell (cx, cy) changed, with the grid already edited.
+    template<class G>
+    void cellChanged(const G& grid, int cx, int cy)
+    {
+        bool opened = grid[grid.idx(cx, cy)] != 1;
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            auto next = std::next(it);
+            if (touches(grid, *it, cx, cy))
+            {
+                drop(it);
+                ++counters.onPath;
+            }
+            else if (opened && it->exact && lowerBound(grid, *it, cx, cy) < it->cost)
+            {
+                drop(it);
+                ++counters.inRegion;
+            }
+            it = next;
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+        index.clear();
+        used = 0;
+    }
+
+    const PathCacheStats& stats() const { return counters; }
+    std::size_t size() const { return entries.size(); }
+    std::size_t bytes() const { return used; }
+
+private:
+    struct Entry
+    {
+        std::uint64_t key;
+        int start, goal;
+        long long cost;
+        bool exact;
+        PathUnits units;
+        int x0, y0, x1, y1;  // bounding box of the path's cells
+        RunLengthPath runs;
+    };
+
+    template<class G>
+    static std::uint64_t key(const G& grid, int start, int goal, int engine)
+    {
+        return (std::uint64_t(start) * std::uint64_t(grid.size()) + std::uint64_t(goal)) * 64u + std::uint64_t(engine);
+    }
+
+    static std::size_t entryBytes(const Entry& e)
+    {
+        return sizeof(Entry) + e.runs.runs.capacity() * sizeof(std::uint16_t) + sizeof(std::uint64_t) + 4 * sizeof(void*);
+    }
+
+    void drop(std::list<Entry>::iterator it)
+    {
+        used -= entryBytes(*it);
+        index.erase(it->key);
+        entries.erase(it);
+    }
+
+    // Whether (cx, cy) is a cell of the path or a corner cut by one of its
+    // diagonal steps.
+    template<class G>
+    static bool touches(const G& grid, const Entry& e, int cx, int cy)
+    {
+        if (cx < e.x0 || cx > e.x1 || cy < e.y0 || cy > e.y1) return false;
+        int x = grid.x(e.start), y = grid.y(e.start);
+        if (x == cx && y == cy) return true;
+        for (std::uint16_t r : e.runs.runs)
+        {
+            int dx = Neighborhood8::DX[r & 7u], dy = Neighborhood8::DY[r & 7u];
+            for (unsigned n = r >> 3; n > 0; --n)
+            {
+                if (dx != 0 && dy != 0 && ((x + dx == cx && y == cy) || (x == cx && y + dy == cy))) return true;
+                x += dx;
+                y += dy;
+                if (x == cx && y == cy) return true;
+            }
+        }
+        return false;
+    }
+
+    // Lower bound on any route the opened cell (cx, cy) can shorten. Besides
+    // routes through the cell, that includes 8-connected ones that only cut
+    // its corner: a diagonal step between two of its 4-neighbours, no longer
+    // blocked. Such a route avoids a straight step on each side of the cell
+    // but pays a diagonal one, so it can beat the octile distance through
+    // the cell by 2 * straight - diagonal. With 4-connected units that is 0.
+    template<class G>
+    static long long lowerBound(const G& grid, const Entry& e, int cx, int cy)
+    {
+        auto octile = [&](int v)
+        {
+            int dx = std::abs(grid.x(v) - cx), dy = std::abs(grid.y(v) - cy);
+            int lo = std::min(dx, dy), hi = std::max(dx, dy);
+            return (long long)lo * e.units.diagonal + (long long)(hi - lo) * e.units.straight;
+        };
+        return octile(e.start) + octile(e.goal) - std::max(0, 2 * e.units.straight - e.units.diagonal);
+    }
+
+    std::list<Entry> entries;  // most recently used first
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    std::size_t used = 0;
+    PathCacheStats counters;
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include "SearchPolicies.hpp"
+#include "LineOfSight.hpp"
+#include <vector>
+#include <cstdint>
+
+// Post-processing for cell paths from any engine: corner extraction, string
+// pulling and a run-length encoding for storage. None of them change the
+// path's cells; they only describe it with fewer numbers. Smoothing looks at
+// walls alone, so on weighted maps the shortcut may cross costlier cells.
+
+// Cells where a path changes direction, plus its two ends.
+template<class G>
+void collapseCollinear(const G& grid, const std::vector<int>& path, std::vector<int>& corners)
+{
+    corners.clear();
+    if (path.empty()) return;
+    corners.push_back(path[0]);
+    for (std::size_t i = 1; i + 1 < path.size(); ++i)
+    {
+        int ax = grid.x(path[i]) - grid.x(path[i - 1]), ay = grid.y(path[i]) - grid.y(path[i - 1]);
+        int bx = grid.x(path[i + 1]) - grid.x(path[i]), by = grid.y(path[i + 1]) - grid.y(path[i]);
+        if (ax != bx || ay != by) corners.push_back(path[i]);
+    }
+    if (path.size() > 1) corners.push_back(path.back());
+}
+
+// String pulling: from each corner, skip ahead to the last path cell still in
+// line of sight and make that the next corner. One check per cell.
+template<class G>
+void smoothPath(const G& grid, const LineOfSight& sight, const std::vector<int>& path, std::vector<int>& corners)
+{
+    corners.clear();
+    if (path.empty()) return;
+    int anchor = path[0];
+    corners.push_back(anchor);
+    for (std::size_t i = 2; i < path.size(); ++i)
+    {
+        int v = path[i];
+        if (sight.clear(grid.x(anchor), grid.y(anchor), grid.x(v), grid.y(v))) continue;
+        anchor = path[i - 1];
+        corners.push_back(anchor);
+    }
+    if (path.size() > 1) corners.push_back(path.back());
+}
+
+// A cell path as its start and one 16-bit word per straight run: the
+// Neighborhood8 direction in the low 3 bits and the run length above them.
+// Runs longer than MAX_RUN are split.
+struct RunLengthPath
+{
+    static constexpr unsigned MAX_RUN = 0xFFFFu >> 3;
+
+    int start = -1;
+    std::vector<std::uint16_t> runs;
+
+    std::size_t cells() const
+    {
+        std::size_t n = start >= 0;
+        for (std::uint16_t r : runs) n += r >> 3;
+        return n;
+    }
+
+    std::size_t bytes() const { return sizeof(start) + runs.capacity() * sizeof(std::uint16_t); }
+};
+
+template<class G>
+void encodeRuns(const G& grid, const std::vector<int>& path, RunLengthPath& out)
+{
+    out.start = path.empty() ? -1 : path[0];
+    out.runs.clear();
+    for (std::size_t i = 1; i < path.size(); ++i)
+    {
+        int dx = grid.x(path[i]) - grid.x(path[i - 1]), dy = grid.y(path[i]) - grid.y(path[i - 1]);
+        unsigned d = 0;
+        while (Neighborhood8::DX[d] != dx || Neighborhood8::DY[d] != dy) ++d;
+        if (!out.runs.empty() && (out.runs.back() & 7u) == d && (out.runs.back() >> 3) < RunLengthPath::MAX_RUN)
+            out.runs.back() = std::uint16_t(out.runs.back() + 8u);
+        else out.runs.push_back(std::uint16_t(d | 8u));
+    }
+}
+
+template<class G>
+void decodeRuns(const G& grid, const RunLengthPath& in, std::vector<int>& path)
+{
+    path.clear();
+    if (in.start < 0) return;
+    int v = in.start;
+    path.push_back(v);
+    for (std::uint16_t r : in.runs)
+    {
+        int dx = Neighborhood8::DX[r & 7u], dy = Neighborhood8::DY[r & 7u];
+        for (unsigned n = r >> 3; n > 0; --n)
+        {
+            v = grid.step(v, dx, dy);
+            path.push_back(v);
+        }
+    }
+}
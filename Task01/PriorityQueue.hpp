@@ -0,0 +1,377 @@
+#pragma once
+#include "Bits.hpp"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Open-list policies for the search engines. All share one interface:
+//   reset(n)      empty the queue; ids will be in [0, n)
+//   push(key, id) insert, or lower the key of a queued id when DecreaseKey
+//   pop()         remove and return the (key, id) pair with the smallest key
+// Lazy queues (DecreaseKey == false) may hold several entries per id and rely
+// on the engine's d > dist[u] check to skip stale ones.
+
+template<class Key>
+class BinaryHeapQueue
+{
+public:
+    static constexpr bool DecreaseKey = false;
+    using Node = std::pair<Key, int>;
+
+    void reset(int) { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+    const Node& top() const { return heap.front(); }
+
+    void push(Key key, int id)
+    {
+        heap.push_back({ key, id });
+        std::push_heap(heap.begin(), heap.end(), Greater{});
+    }
+
+    Node pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), Greater{});
+        Node n = heap.back();
+        heap.pop_back();
+        return n;
+    }
+
+private:
+    struct Greater
+    {
+        bool operator()(const Node& a, const Node& b) const { return a.first > b.first; }
+    };
+    std::vector<Node> heap;
+};
+
+// Implicit D-ary heap; D = 4 keeps all children of a node in one cache line.
+template<class Key, int D = 4>
+class DaryHeapQueue
+{
+public:
+    static constexpr bool DecreaseKey = false;
+    using Node = std::pair<Key, int>;
+
+    void reset(int) { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+
+    void push(Key key, int id)
+    {
+        std::size_t i = heap.size();
+        heap.push_back({ key, id });
+        siftUp(i);
+    }
+
+    Node pop()
+    {
+        Node top = heap.front();
+        Node last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap.front() = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void siftUp(std::size_t i)
+    {
+        Node n = heap[i];
+        while (i > 0)
+        {
+            std::size_t p = (i - 1) / D;
+            if (!(n.first < heap[p].first)) break;
+            heap[i] = heap[p];
+            i = p;
+        }
+        heap[i] = n;
+    }
+
+    void siftDown(std::size_t i)
+    {
+        Node n = heap[i];
+        std::size_t size = heap.size();
+        for (;;)
+        {
+            std::size_t first = D * i + 1;
+            if (first >= size) break;
+            std::size_t last = std::min(first + D, size), best = first;
+            for (std::size_t c = first + 1; c < last; ++c)
+                if (heap[c].first < heap[best].first) best = c;
+            if (!(heap[best].first < n.first)) break;
+            heap[i] = heap[best];
+            i = best;
+        }
+        heap[i] = n;
+    }
+
+    std::vector<Node> heap;
+};
+
+// D-ary heap with a position map: one entry per id, push() on a queued id is
+// a decrease-key, so the engine never pops a stale node.
+template<class Key, int D = 4>
+class IndexedHeapQueue
+{
+public:
+    static constexpr bool DecreaseKey = true;
+    using Node = std::pair<Key, int>;
+
+    void reset(int n)
+    {
+        heap.clear();
+        pos.assign(n, -1);
+    }
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+
+    void push(Key key, int id)
+    {
+        int i = pos[id];
+        if (i < 0)
+        {
+            i = int(heap.size());
+            heap.push_back({ key, id });
+        }
+        else if (key < heap[i].first)
+        {
+            heap[i].first = key;
+        }
+        else
+        {
+            return;
+        }
+        siftUp(i);
+    }
+
+    Node pop()
+    {
+        Node top = heap.front();
+        pos[top.second] = -1;
+        Node last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap.front() = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void siftUp(int i)
+    {
+        Node n = heap[i];
+        while (i > 0)
+        {
+            int p = (i - 1) / D;
+            if (!(n.first < heap[p].first)) break;
+            heap[i] = heap[p];
+            pos[heap[i].second] = i;
+            i = p;
+        }
+        heap[i] = n;
+        pos[n.second] = i;
+    }
+
+    void siftDown(int i)
+    {
+        Node n = heap[i];
+        int size = int(heap.size());
+        for (;;)
+        {
+            int first = D * i + 1;
+            if (first >= size) break;
+            int last = std::min(first + D, size), best = first;
+            for (int c = first + 1; c < last; ++c)
+                if (heap[c].first < heap[best].first) best = c;
+            if (!(heap[best].first < n.first)) break;
+            heap[i] = heap[best];
+            pos[heap[i].second] = i;
+            i = best;
+        }
+        heap[i] = n;
+        pos[n.second] = i;
+    }
+
+    std::vector<Node> heap;
+    std::vector<int> pos;
+};
+
+// Pairing heap over a node pool indexed by id, with O(1) decrease-key.
+template<class Key>
+class PairingHeapQueue
+{
+public:
+    static constexpr bool DecreaseKey = true;
+    using Node = std::pair<Key, int>;
+
+    void reset(int n)
+    {
+        nodes.assign(n, Entry{});
+        root = -1;
+        count = 0;
+    }
+    bool empty() const { return root < 0; }
+    std::size_t size() const { return count; }
+
+    void push(Key key, int id)
+    {
+        Entry& e = nodes[id];
+        if (!e.queued)
+        {
+            e = Entry{};
+            e.key = key;
+            e.queued = true;
+            ++count;
+            root = root < 0 ? id : meld(root, id);
+            return;
+        }
+        if (!(key < e.key)) return;
+        e.key = key;
+        if (id == root) return;
+        detach(id);
+        root = meld(root, id);
+    }
+
+    Node pop()
+    {
+        int top = root;
+        Entry& e = nodes[top];
+        e.queued = false;
+        --count;
+        root = mergePairs(e.child);
+        if (root >= 0) nodes[root].prev = -1;
+        return { e.key, top };
+    }
+
+private:
+    struct Entry
+    {
+        Key key{};
+        int child = -1, next = -1, prev = -1;  // prev: left sibling, or parent for a first child
+        bool queued = false;
+    };
+
+    int meld(int a, int b)
+    {
+        if (nodes[b].key < nodes[a].key) std::swap(a, b);
+        Entry& pa = nodes[a];
+        Entry& cb = nodes[b];
+        cb.prev = a;
+        cb.next = pa.child;
+        if (pa.child >= 0) nodes[pa.child].prev = b;
+        pa.child = b;
+        pa.next = pa.prev = -1;
+        return a;
+    }
+
+    void detach(int id)
+    {
+        Entry& e = nodes[id];
+        Entry& p = nodes[e.prev];
+        if (p.child == id) p.child = e.next;
+        else p.next = e.next;
+        if (e.next >= 0) nodes[e.next].prev = e.prev;
+        e.next = e.prev = -1;
+    }
+
+    int mergePairs(int first)
+    {
+        if (first < 0) return -1;
+        pairs.clear();
+        for (int a = first; a >= 0;)
+        {
+            int b = nodes[a].next;
+            int rest = b >= 0 ? nodes[b].next : -1;
+            nodes[a].next = nodes[a].prev = -1;
+            if (b >= 0)
+            {
+                nodes[b].next = nodes[b].prev = -1;
+                pairs.push_back(meld(a, b));
+            }
+            else
+            {
+                pairs.push_back(a);
+            }
+            a = rest;
+        }
+        int r = pairs.back();
+        for (int i = int(pairs.size()) - 2; i >= 0; --i)
+            r = meld(pairs[i], r);
+        return r;
+    }
+
+    std::vector<Entry> nodes;
+    std::vector<int> pairs;
+    int root = -1;
+    std::size_t count = 0;
+};
+
+// Monotone radix heap for unsigned-convertible integer keys: every pushed key
+// must be >= the last popped key, which holds for Dijkstra with non-negative
+// costs. Buckets by the highest bit that differs from the last popped key.
+template<class Key>
+class RadixHeapQueue
+{
+    static_assert(std::is_integral<Key>::value, "RadixHeapQueue needs integer keys");
+
+public:
+    static constexpr bool DecreaseKey = false;
+    using Node = std::pair<Key, int>;
+    using UKey = std::make_unsigned_t<Key>;
+    static constexpr int BUCKETS = int(sizeof(Key)) * 8 + 1;
+
+    void reset(int)
+    {
+        for (auto& b : buckets) b.clear();
+        last = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return count; }
+
+    void push(Key key, int id)
+    {
+        buckets[bucketOf(UKey(key))].push_back({ key, id });
+        ++count;
+    }
+
+    Node pop()
+    {
+        if (buckets[0].empty())
+        {
+            int i = 1;
+            while (buckets[i].empty()) ++i;
+            UKey mn = UKey(buckets[i][0].first);
+            for (const Node& n : buckets[i])
+                if (UKey(n.first) < mn) mn = UKey(n.first);
+            last = mn;
+            for (const Node& n : buckets[i])
+                buckets[bucketOf(UKey(n.first))].push_back(n);
+            buckets[i].clear();
+        }
+        Node n = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return n;
+    }
+
+private:
+    int bucketOf(UKey key) const
+    {
+        UKey diff = key ^ last;
+        return diff ? highestBit(std::uint64_t(diff)) + 1 : 0;
+    }
+
+    std::vector<Node> buckets[BUCKETS];
+    UKey last = 0;
+    std::size_t count = 0;
+};
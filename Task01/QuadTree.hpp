@@ -0,0 +1,294 @@
+#pragma once
+#include "Search.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+// Region quadtree over the passability grid: squares are split until each
+// leaf is all free or all wall (cells beyond the map count as wall). A query
+// runs A* over the free leaves, node to node between square centres, then
+// refines the route into cells by walking each square straight to the edge
+// it shares with the next. Neither step is exact, so paths can come out
+// somewhat longer than a flat search's.
+//
+// update() re-splits or merges only the squares on the edited cell's branch.
+class QuadTree
+{
+public:
+    template<class G>
+    void build(const G& grid)
+    {
+        width = grid.width;
+        height = grid.height;
+        side = 1;
+        while (side < std::max(width, height)) side *= 2;
+        nodes.clear();
+        freeBlocks.clear();
+        nodes.push_back(Node{ 0, 0, side, -1, MIXED });
+        split(grid, 0);
+        leafOf.assign(grid.size(), -1);
+        assignLeaves(grid, 0);
+    }
+
+    // Call after cell (cx, cy) changed, with the grid already edited.
+    template<class G>
+    void update(const G& grid, int cx, int cy)
+    {
+        if (empty()) return;
+        std::uint8_t want = grid[grid.idx(cx, cy)] == 1 ? WALL : FREE;
+        std::vector<int> branch{ 0 };
+        while (nodes[branch.back()].child >= 0) branch.push_back(childAt(branch.back(), cx, cy));
+        int top = branch.back();
+        if (nodes[top].state == want) return;
+
+        // Split the leaf down to the cell, then merge back up while all four
+        // children of a node agree.
+        while (nodes[branch.back()].size > 1)
+        {
+            int n = branch.back();
+            std::uint8_t state = nodes[n].state;
+            nodes[n].state = MIXED;
+            nodes[n].child = allocBlock();
+            int half = nodes[n].size / 2;
+            for (int c = 0; c < 4; ++c)
+                nodes[nodes[n].child + c] = Node{ nodes[n].x + (c & 1) * half, nodes[n].y + (c >> 1) * half,
+                                                  half, -1, state };
+            branch.push_back(childAt(n, cx, cy));
+        }
+        nodes[branch.back()].state = want;
+        for (int i = int(branch.size()) - 2; i >= 0; --i)
+        {
+            int n = branch[i];
+            if (!tryMerge(n)) break;
+            top = n;
+        }
+        assignLeaves(grid, top);
+    }
+
+    template<bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        path.clear();
+        lastCost = -1;
+        int from = leafOf[startIdx], to = leafOf[goalIdx];
+        if (from < 0 || to < 0 || nodes[from].state != FREE || nodes[to].state != FREE)
+        {
+            rec.finish();
+            return false;
+        }
+
+        if (int(dist.size()) < int(nodes.size()))
+        {
+            dist.resize(nodes.size(), INF);
+            parent.resize(nodes.size(), -1);
+        }
+        for (int n : touched) dist[n] = INF;
+        touched.clear();
+
+        RadixHeapQueue<int> pq;
+        pq.reset(int(nodes.size()));
+        dist[from] = 0;
+        parent[from] = -1;
+        touched.push_back(from);
+        pq.push(centreDistance(from, to), from);
+        rec.push(pq.size());
+        while (!pq.empty())
+        {
+            auto [f, u] = pq.pop();
+            rec.pop();
+            if (f > dist[u] + centreDistance(u, to)) { rec.stale(); continue; }
+            if (u == to) break;
+            forEachNeighbour(grid, u, [&](int v)
+            {
+                int nd = dist[u] + centreDistance(u, v);
+                if (nd >= dist[v]) return;
+                if (dist[v] == INF) touched.push_back(v);
+                dist[v] = nd;
+                parent[v] = u;
+                rec.relax();
+                pq.push(nd + centreDistance(v, to), v);
+                rec.push(pq.size());
+            });
+        }
+        rec.finish();
+        if (dist[to] == INF) return false;
+
+        route.clear();
+        for (int n = to; n >= 0; n = parent[n]) route.push_back(n);
+        std::reverse(route.begin(), route.end());
+
+        // Walk each square straight to the point of its shared edge nearest
+        // the current cell, step across, and finish at the goal.
+        int x = grid.x(startIdx), y = grid.y(startIdx);
+        path.push_back(startIdx);
+        auto walk = [&](int tx, int ty)
+        {
+            for (; x != tx; x += tx > x ? 1 : -1) path.push_back(grid.idx(x + (tx > x ? 1 : -1), y));
+            for (; y != ty; y += ty > y ? 1 : -1) path.push_back(grid.idx(x, y + (ty > y ? 1 : -1)));
+        };
+        for (std::size_t i = 0; i + 1 < route.size(); ++i)
+        {
+            const Node& a = nodes[route[i]];
+            const Node& b = nodes[route[i + 1]];
+            if (b.x + b.size == a.x || a.x + a.size == b.x)
+            {
+                int ty = std::clamp(y, std::max(a.y, b.y), std::min(a.y + a.size, b.y + b.size) - 1);
+                int tx = b.x < a.x ? a.x : a.x + a.size - 1;
+                walk(tx, ty);
+                walk(b.x < a.x ? tx - 1 : tx + 1, ty);
+            }
+            else
+            {
+                int tx = std::clamp(x, std::max(a.x, b.x), std::min(a.x + a.size, b.x + b.size) - 1);
+                int ty = b.y < a.y ? a.y : a.y + a.size - 1;
+                walk(tx, ty);
+                walk(tx, b.y < a.y ? ty - 1 : ty + 1);
+            }
+        }
+        walk(grid.x(goalIdx), grid.y(goalIdx));
+        lastCost = (long long)path.size() - 1;
+        return true;
+    }
+
+    long long cost() const { return lastCost; }
+    int routeLength() const { return int(route.size()); }  // leaves on the last coarse route
+    bool empty() const { return nodes.empty(); }
+    bool matches(int w, int h) const { return width == w && height == h; }
+
+    int freeLeaves() const
+    {
+        int n = 0;
+        for (const Node& node : nodes) n += node.child < 0 && node.state == FREE && node.size > 0;
+        return n;
+    }
+
+    int leaves() const
+    {
+        int n = 0;
+        for (const Node& node : nodes) n += node.child < 0 && node.size > 0;
+        return n;
+    }
+
+    std::size_t bytes() const
+    {
+        return nodes.capacity() * sizeof(Node) + (leafOf.capacity() + freeBlocks.capacity() + dist.capacity() +
+               parent.capacity() + touched.capacity() + route.capacity()) * sizeof(int);
+    }
+
+private:
+    static constexpr std::uint8_t FREE = 0, WALL = 1, MIXED = 2;
+
+    struct Node
+    {
+        int x, y, size;
+        int child;           // first of four consecutive children, -1 on leaves
+        std::uint8_t state;  // FREE or WALL on leaves, MIXED inside
+    };
+
+    int childAt(int n, int x, int y) const
+    {
+        const Node& node = nodes[n];
+        int half = node.size / 2;
+        return node.child + (x >= node.x + half) + 2 * (y >= node.y + half);
+    }
+
+    int allocBlock()
+    {
+        if (!freeBlocks.empty())
+        {
+            int b = freeBlocks.back();
+            freeBlocks.pop_back();
+            return b;
+        }
+        nodes.resize(nodes.size() + 4);
+        return int(nodes.size()) - 4;
+    }
+
+    bool tryMerge(int n)
+    {
+        int c = nodes[n].child;
+        std::uint8_t state = nodes[c].state;
+        for (int i = 0; i < 4; ++i)
+            if (nodes[c + i].child >= 0 || nodes[c + i].state != state) return false;
+        for (int i = 0; i < 4; ++i) nodes[c + i].size = 0;
+        freeBlocks.push_back(c);
+        nodes[n].child = -1;
+        nodes[n].state = state;
+        return true;
+    }
+
+    template<class G>
+    void split(const G& grid, int n)
+    {
+        Node node = nodes[n];
+        if (node.size == 1)
+        {
+            bool open = grid.inside(node.x, node.y) && grid[grid.idx(node.x, node.y)] != 1;
+            nodes[n].state = open ? FREE : WALL;
+            return;
+        }
+        int c = allocBlock(), half = node.size / 2;
+        nodes[n].child = c;
+        for (int i = 0; i < 4; ++i)
+        {
+            nodes[c + i] = Node{ node.x + (i & 1) * half, node.y + (i >> 1) * half, half, -1, MIXED };
+            split(grid, c + i);
+        }
+        tryMerge(n);
+    }
+
+    template<class G>
+    void assignLeaves(const G& grid, int n)
+    {
+        const Node& node = nodes[n];
+        if (node.child >= 0)
+        {
+            for (int i = 0; i < 4; ++i) assignLeaves(grid, node.child + i);
+            return;
+        }
+        for (int y = node.y; y < std::min(node.y + node.size, height); ++y)
+            for (int x = node.x; x < std::min(node.x + node.size, width); ++x) leafOf[grid.idx(x, y)] = n;
+    }
+
+    // Free leaves sharing an edge with leaf u, read off the cells along its
+    // four sides.
+    template<class G, class F>
+    void forEachNeighbour(const G& grid, int u, F&& f) const
+    {
+        const Node& node = nodes[u];
+        auto scan = [&](int x, int y, int dx, int dy)
+        {
+            int last = -1;
+            for (int i = 0; i < node.size; ++i, x += dx, y += dy)
+            {
+                if (!grid.inside(x, y)) continue;
+                int v = leafOf[grid.idx(x, y)];
+                if (v == last) continue;
+                last = v;
+                if (nodes[v].state == FREE) f(v);
+            }
+        };
+        scan(node.x - 1, node.y, 0, 1);
+        scan(node.x + node.size, node.y, 0, 1);
+        scan(node.x, node.y - 1, 1, 0);
+        scan(node.x, node.y + node.size, 1, 0);
+    }
+
+    // Manhattan distance between square centres, in half cells.
+    int centreDistance(int a, int b) const
+    {
+        const Node& p = nodes[a];
+        const Node& q = nodes[b];
+        return std::abs(2 * p.x + p.size - 2 * q.x - q.size) + std::abs(2 * p.y + p.size - 2 * q.y - q.size);
+    }
+
+    int width = 0, height = 0, side = 0;
+    std::vector<Node> nodes;
+    std::vector<int> freeBlocks;
+    std::vector<int> leafOf;  // leaf per slot, -1 in the padding
+
+    std::vector<int> dist, parent, touched, route;
+    long long lastCost = -1;
+};
@@ -0,0 +1,266 @@
+#pragma once
+#include "Grid.hpp"
+#include "SearchPolicies.hpp"
+#include "Bits.hpp"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Rectangular symmetry reduction, 4-connected. Free space is split greedily
+// into empty rectangles; searches then only expand their perimeter cells,
+// crossing a rectangle in one macro move instead of through its interior.
+// update() re-splits just the rectangles around an edited cell.
+class EmptyRectangles
+{
+public:
+    struct Rect
+    {
+        int x0, y0, x1, y1;
+
+        bool onPerimeter(int x, int y) const { return x == x0 || x == x1 || y == y0 || y == y1; }
+    };
+
+    template<class G>
+    void build(const G& grid)
+    {
+        width = grid.width;
+        height = grid.height;
+        roomOf.assign(grid.size(), -1);
+        rects.clear();
+        freeIds.clear();
+        std::vector<int> cells;
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x) cells.push_back(grid.idx(x, y));
+        split(grid, cells);
+        moveMasks.assign(grid.size(), 0);
+        refreshMoves(grid, 0, 0, width - 1, height - 1);
+    }
+
+    // Call after cell (cx, cy) changed, with the grid already edited. The
+    // rectangles touching the cell or its four neighbours are dissolved and
+    // their cells split again.
+    template<class G>
+    void update(const G& grid, int cx, int cy)
+    {
+        if (empty()) return;
+        std::vector<int> cells;
+        int x0 = cx, y0 = cy, x1 = cx, y1 = cy;
+        auto dissolve = [&](int x, int y)
+        {
+            if (!grid.inside(x, y)) return;
+            int id = roomOf[grid.idx(x, y)];
+            if (id < 0) return;
+            Rect r = rects[id];
+            x0 = std::min(x0, r.x0);
+            y0 = std::min(y0, r.y0);
+            x1 = std::max(x1, r.x1);
+            y1 = std::max(y1, r.y1);
+            for (int ry = r.y0; ry <= r.y1; ++ry)
+                for (int rx = r.x0; rx <= r.x1; ++rx)
+                {
+                    int v = grid.idx(rx, ry);
+                    roomOf[v] = -1;
+                    cells.push_back(v);
+                }
+            freeIds.push_back(id);
+        };
+        dissolve(cx, cy);
+        for (int k = 0; k < 4; ++k) dissolve(cx + Neighborhood4::DX[k], cy + Neighborhood4::DY[k]);
+        cells.push_back(grid.idx(cx, cy));
+        std::sort(cells.begin(), cells.end(), [&](int a, int b)
+        {
+            return grid.y(a) != grid.y(b) ? grid.y(a) < grid.y(b) : grid.x(a) < grid.x(b);
+        });
+        split(grid, cells);
+        refreshMoves(grid, x0 - 1, y0 - 1, x1 + 1, y1 + 1);
+    }
+
+    int room(int v) const { return roomOf[v]; }
+    // Bits 0-3: plain Neighborhood4 moves out of slot v; bits 4-7: moves
+    // that jump across its rectangle instead.
+    std::uint8_t moves(int v) const { return moveMasks[v]; }
+    const Rect& rect(int id) const { return rects[id]; }
+    int count() const { return int(rects.size() - freeIds.size()); }
+    int ids() const { return int(rects.size()); }  // ids are below this, some unused after update()
+    bool empty() const { return roomOf.empty(); }
+    bool matches(int w, int h) const { return width == w && height == h; }
+
+    std::size_t bytes() const
+    {
+        return (roomOf.capacity() + freeIds.capacity()) * sizeof(int) + rects.capacity() * sizeof(Rect) +
+               moveMasks.capacity();
+    }
+
+    // Cells a search can still expand: perimeter cells of every rectangle.
+    template<class G>
+    int perimeterCells(const G& grid) const
+    {
+        int n = 0;
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+            {
+                int id = roomOf[grid.idx(x, y)];
+                n += id >= 0 && rects[id].onPerimeter(x, y);
+            }
+        return n;
+    }
+
+private:
+    // cells in row-major order; every free one left unassigned gets a
+    // rectangle grown from it, alternately right and down while the new
+    // column or row is free and unassigned.
+    template<class G>
+    void split(const G& grid, const std::vector<int>& cells)
+    {
+        auto open = [&](int x, int y)
+        {
+            return grid.inside(x, y) && grid[grid.idx(x, y)] != 1 && roomOf[grid.idx(x, y)] < 0;
+        };
+        for (int v : cells)
+        {
+            if (grid[v] == 1 || roomOf[v] >= 0) continue;
+            Rect r{ grid.x(v), grid.y(v), grid.x(v), grid.y(v) };
+            for (bool right = true, down = true; right || down;)
+            {
+                if (right)
+                {
+                    for (int y = r.y0; y <= r.y1 && right; ++y) right = open(r.x1 + 1, y);
+                    if (right) ++r.x1;
+                }
+                if (down)
+                {
+                    for (int x = r.x0; x <= r.x1 && down; ++x) down = open(x, r.y1 + 1);
+                    if (down) ++r.y1;
+                }
+            }
+            int id;
+            if (!freeIds.empty())
+            {
+                id = freeIds.back();
+                freeIds.pop_back();
+                rects[id] = r;
+            }
+            else
+            {
+                id = int(rects.size());
+                rects.push_back(r);
+            }
+            for (int y = r.y0; y <= r.y1; ++y)
+                for (int x = r.x0; x <= r.x1; ++x) roomOf[grid.idx(x, y)] = id;
+        }
+    }
+
+    // A move is plain when it leaves the rectangle or runs along its
+    // perimeter, a jump when it heads into the interior.
+    template<class G>
+    void refreshMoves(const G& grid, int x0, int y0, int x1, int y1)
+    {
+        for (int y = std::max(0, y0); y <= std::min(height - 1, y1); ++y)
+            for (int x = std::max(0, x0); x <= std::min(width - 1, x1); ++x)
+            {
+                int v = grid.idx(x, y), id = roomOf[v];
+                std::uint8_t m = 0;
+                if (id >= 0)
+                {
+                    const Rect& r = rects[id];
+                    bool perimeter = r.onPerimeter(x, y);
+                    for (int d = 0; d < 4; ++d)
+                    {
+                        int nx = x + Neighborhood4::DX[d], ny = y + Neighborhood4::DY[d];
+                        if (!grid.inside(nx, ny) || grid[grid.idx(nx, ny)] == 1) continue;
+                        bool inside = nx >= r.x0 && nx <= r.x1 && ny >= r.y0 && ny <= r.y1;
+                        m |= std::uint8_t(!inside || (perimeter && r.onPerimeter(nx, ny)) ? 1 << d : 16 << d);
+                    }
+                }
+                moveMasks[v] = m;
+            }
+    }
+
+    int width = 0, height = 0;
+    std::vector<std::uint8_t> moveMasks;
+    std::vector<int> roomOf;   // rectangle id per slot, -1 on walls
+    std::vector<Rect> rects;
+    std::vector<int> freeIds;
+};
+
+// The grid as a reduced-graph search sees it: the base grid plus its
+// rectangles and the goal of the current query, which macro moves stop at.
+template<class G>
+struct ReducedGrid
+{
+    const G& base;
+    const EmptyRectangles& rects;
+    int goal = -1;
+    int width = base.width, height = base.height;
+
+    int size() const { return base.size(); }
+    int idx(int x, int y) const { return base.idx(x, y); }
+    int x(int i) const { return base.x(i); }
+    int y(int i) const { return base.y(i); }
+    int step(int i, int ddx, int ddy) const { return base.step(i, ddx, ddy); }
+    bool inside(int x, int y) const { return base.inside(x, y); }
+    int operator[](int i) const { return base[i]; }
+};
+
+// Neighborhood over a ReducedGrid. Perimeter cells step to their neighbours
+// outside the interior and jump straight across it to the opposite side;
+// interior cells jump to the perimeter on all four sides. In the goal's
+// rectangle a jump stops level with the goal, so the next one reaches it;
+// the start and those stops are the only interior cells expanded. Move k
+// packs the direction in its low two bits and the length above them, so
+// costs stay a function of (v, k); store moves with FullStorage, not
+// CompactStorage.
+struct RsrNeighborhood4 : Neighborhood4
+{
+    template<class Dist> static constexpr Dist cost(int k) { return Dist(k / 4 + 1) * straight<Dist>(); }
+    template<class Dist, class G> static constexpr Dist cost(const G&, int, int k) { return cost<Dist>(k); }
+
+    template<class G, class F>
+    static void forEach(const G& grid, int u, F&& f)
+    {
+        unsigned m = grid.rects.moves(u);
+        for (unsigned plain = m & 15u; plain; plain &= plain - 1)
+        {
+            int d = lowestBit(plain);
+            f(grid.step(u, DX[d], DY[d]), d);
+        }
+        if (!(m >> 4)) return;
+
+        int id = grid.rects.room(u);
+        const EmptyRectangles::Rect& r = grid.rects.rect(id);
+        int ux = grid.x(u), uy = grid.y(u);
+        bool goalHere = grid.goal >= 0 && grid.rects.room(grid.goal) == id;
+        for (unsigned jump = m >> 4; jump; jump &= jump - 1)
+        {
+            int d = lowestBit(jump), dx = DX[d], dy = DY[d];
+            int len = dx > 0 ? r.x1 - ux : dx < 0 ? ux - r.x0 : dy > 0 ? r.y1 - uy : uy - r.y0;
+            if (goalHere)
+            {
+                int along = dx != 0 ? (grid.x(grid.goal) - ux) * dx : (grid.y(grid.goal) - uy) * dy;
+                if (along > 0 && along < len) len = along;
+            }
+            f(grid.step(u, len * dx, len * dy), d + 4 * (len - 1));
+        }
+    }
+};
+
+// Fills the straight runs a reduced search jumped over back into path.
+template<class G>
+void expandReducedPath(const G& grid, std::vector<int>& path)
+{
+    if (path.size() < 2) return;
+    std::vector<int> full{ path[0] };
+    for (std::size_t i = 1; i < path.size(); ++i)
+    {
+        int x = grid.x(path[i - 1]), y = grid.y(path[i - 1]);
+        int tx = grid.x(path[i]), ty = grid.y(path[i]);
+        int dx = (tx > x) - (tx < x), dy = (ty > y) - (ty < y);
+        while (x != tx || y != ty)
+        {
+            x += dx;
+            y += dy;
+            full.push_back(grid.idx(x, y));
+        }
+    }
+    path.swap(full);
+}
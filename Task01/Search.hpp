@@ -0,0 +1,159 @@
+#pragma once
+#include "Grid.hpp"
+#include "PriorityQueue.hpp"
+#include "SearchPolicies.hpp"
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+
+struct SearchStats
+{
+    long long popped = 0;     // nodes taken off the open list, stale ones included
+    long long stale = 0;      // pops skipped by d > dist[u]
+    long long pushed = 0;
+    long long relaxed = 0;    // successful dist[v] improvements
+    std::size_t peakOpen = 0;
+    double elapsedMs = 0.0;
+};
+
+// Engines take the recorder as a template flag so the uninstrumented build keeps
+// a bare inner loop: every call below is an empty inline function.
+template<bool Enabled>
+struct StatsRecorder
+{
+    explicit StatsRecorder(SearchStats&) {}
+    void pop() {}
+    void stale() {}
+    void push(std::size_t) {}
+    void relax() {}
+    void finish() {}
+};
+
+template<>
+struct StatsRecorder<true>
+{
+    SearchStats& s;
+    std::chrono::steady_clock::time_point t0;
+
+    explicit StatsRecorder(SearchStats& stats)
+        : s(stats), t0(std::chrono::steady_clock::now())
+    {
+        s = SearchStats{};
+    }
+    void pop() { ++s.popped; }
+    void stale() { ++s.stale; }
+    void push(std::size_t open)
+    {
+        ++s.pushed;
+        if (open > s.peakOpen) s.peakOpen = open;
+    }
+    void relax() { ++s.relaxed; }
+    void finish()
+    {
+        s.elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+    }
+};
+
+// Generic best-first search: Dijkstra with ZeroHeuristic, A* otherwise. The
+// queue key type must match Storage::Dist. goalIdx < 0 floods the whole map.
+template<class Neighborhood, class Heuristic, class Queue, class Storage, bool Instrument = false, class G>
+void search(const G& grid, int startIdx, int goalIdx,
+            Storage& store, SearchStats& stats, Heuristic& h)
+{
+    using Dist = typename Storage::Dist;
+    static_assert(std::is_same<typename Queue::Node::first_type, Dist>::value,
+                  "queue key type must match the storage distance type");
+
+    StatsRecorder<Instrument> rec(stats);
+    store.reset(grid.size());
+    store.setStart(startIdx);
+    if (goalIdx >= 0) h.setGoal(grid, goalIdx);
+
+    Queue pq;
+    pq.reset(grid.size());
+    pq.push(h.template estimate<Neighborhood, Dist>(grid, startIdx), startIdx);
+    rec.push(pq.size());
+
+    while (!pq.empty())
+    {
+        if constexpr (Cancels<Heuristic>::value)
+            if (h.cancelled()) break;
+        auto [f, u] = pq.pop();
+        rec.pop();
+        Dist d = store.get(u);
+        if (f > d + h.template estimate<Neighborhood, Dist>(grid, u)) { rec.stale(); continue; }
+        if (u == goalIdx) break;
+
+        Neighborhood::forEach(grid, u, [&](int v, int k)
+        {
+            if constexpr (PrunesMoves<Heuristic>::value)
+                if (goalIdx >= 0 && !h.allows(grid, u, k)) return;
+            Dist nd = d + Neighborhood::template cost<Dist>(grid, v, k);
+            if (nd < store.get(v))
+            {
+                store.template set<Neighborhood>(v, nd, u, k);
+                rec.relax();
+                pq.push(nd + h.template estimate<Neighborhood, Dist>(grid, v), v);
+                rec.push(pq.size());
+            }
+        });
+    }
+    rec.finish();
+}
+
+// Exact distance tables from each landmark, flooded with the same policies
+// the heuristic will be used with.
+template<class Neighborhood, class Dist, class G>
+LandmarkHeuristic<Dist> makeLandmarkHeuristic(const G& grid, const std::vector<int>& landmarks)
+{
+    LandmarkHeuristic<Dist> lh;
+    FullStorage<Dist> store;
+    SearchStats stats;
+    ZeroHeuristic zero;
+    for (int l : landmarks)
+    {
+        search<Neighborhood, ZeroHeuristic, BinaryHeapQueue<Dist>, FullStorage<Dist>>(
+            grid, l, -1, store, stats, zero);
+        lh.cells.push_back(l);
+        lh.tables.push_back(store.dist);
+    }
+    return lh;
+}
+
+template<bool Instrument = false, class Queue = BinaryHeapQueue<int>>
+void dijkstra(const Grid& grid, int startIdx, int goalIdx,
+              std::vector<int>& dist, std::vector<int>& prev, SearchStats& stats)
+{
+    FullStorage<int> store;
+    store.dist.swap(dist);
+    store.prev.swap(prev);
+    ZeroHeuristic h;
+    search<Neighborhood4, ZeroHeuristic, Queue, FullStorage<int>, Instrument>(
+        grid, startIdx, goalIdx, store, stats, h);
+    store.dist.swap(dist);
+    store.prev.swap(prev);
+}
+
+template<class Storage, class G>
+bool buildPath(const G& grid, const Storage& store, int goalIdx, std::vector<int>& path)
+{
+    path.clear();
+    if (!store.reached(goalIdx)) return false;
+    for (int u = goalIdx; u != -1; u = store.parent(grid, u))
+        path.push_back(u);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+inline bool buildPath(const std::vector<int>& dist, const std::vector<int>& prev,
+                      int goalIdx, std::vector<int>& path)
+{
+    path.clear();
+    if (dist[goalIdx] == INF) return false;
+    for (int u = goalIdx; u != -1; u = prev[u])
+        path.push_back(u);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
@@ -0,0 +1,252 @@
+#pragma once
+#include "Grid.hpp"
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+
+// Policies plugged into search<>() in Search.hpp. Everything is resolved at
+// compile time: each combination instantiates its own inner loop.
+
+template<class Dist>
+constexpr Dist distInf() { return std::numeric_limits<Dist>::max(); }
+
+// Neighborhoods enumerate the passable moves out of u as f(v, k), where k
+// indexes DX/DY, and give the cost of move k for a distance type. Engines
+// call cost<Dist>(grid, v, k) so weighted variants can read the cell entered.
+struct Neighborhood4
+{
+    static constexpr int COUNT = 4;
+    static constexpr int DX[4] = { 1, -1,  0,  0 };
+    static constexpr int DY[4] = { 0,  0,  1, -1 };
+
+    template<class Dist> static constexpr Dist straight() { return Dist(1); }
+    template<class Dist> static constexpr Dist diagonal() { return Dist(2); }
+    template<class Dist> static constexpr Dist cost(int) { return Dist(1); }
+    template<class Dist, class G> static constexpr Dist cost(const G&, int, int) { return Dist(1); }
+
+    template<class G, class F>
+    static void forEach(const G& grid, int u, F&& f)
+    {
+        int ux = grid.x(u), uy = grid.y(u);
+        for (int k = 0; k < 4; ++k)
+        {
+            int vx = ux + DX[k], vy = uy + DY[k];
+            if (!grid.inside(vx, vy)) continue;
+            int v = grid.idx(vx, vy);
+            if (grid[v] == 1) continue;
+            f(v, k);
+        }
+    }
+};
+
+// 8-connected without corner cutting: a diagonal needs both orthogonal cells
+// free. Integer distances use 10/14 so octile estimates stay exact.
+struct Neighborhood8
+{
+    static constexpr int COUNT = 8;
+    static constexpr int DX[8] = { 1, -1,  0,  0, 1, -1,  1, -1 };
+    static constexpr int DY[8] = { 0,  0,  1, -1, 1,  1, -1, -1 };
+
+    template<class Dist> static constexpr Dist straight()
+    {
+        return std::is_integral<Dist>::value ? Dist(10) : Dist(1);
+    }
+    template<class Dist> static constexpr Dist diagonal()
+    {
+        return std::is_integral<Dist>::value ? Dist(14) : Dist(1.41421356237);
+    }
+    template<class Dist> static constexpr Dist cost(int k)
+    {
+        return k < 4 ? straight<Dist>() : diagonal<Dist>();
+    }
+    template<class Dist, class G> static constexpr Dist cost(const G&, int, int k) { return cost<Dist>(k); }
+
+    template<class G, class F>
+    static void forEach(const G& grid, int u, F&& f)
+    {
+        int ux = grid.x(u), uy = grid.y(u);
+        bool open[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            int vx = ux + DX[k], vy = uy + DY[k];
+            open[k] = grid.inside(vx, vy) && grid[grid.idx(vx, vy)] != 1;
+            if (open[k]) f(grid.idx(vx, vy), k);
+        }
+        for (int k = 4; k < 8; ++k)
+        {
+            int ox = DX[k] > 0 ? 0 : 1, oy = DY[k] > 0 ? 2 : 3;
+            if (!open[ox] || !open[oy]) continue;
+            int v = grid.idx(ux + DX[k], uy + DY[k]);
+            if (grid[v] == 1) continue;
+            f(v, k);
+        }
+    }
+};
+
+// Heuristics get the goal once per search, then estimate<N, Dist>(grid, u).
+// One that also has allows(grid, u, k) prunes moves: goal-directed searches
+// skip move k out of u when it returns false.
+template<class H, class = void>
+struct PrunesMoves : std::false_type {};
+template<class H>
+struct PrunesMoves<H, std::void_t<decltype(std::declval<const H&>().allows(std::declval<const Grid&>(), 0, 0))>>
+    : std::true_type {};
+
+// One that also has cancelled() is polled once per expansion and ends the
+// search when it returns true, leaving the storage half filled.
+template<class H, class = void>
+struct Cancels : std::false_type {};
+template<class H>
+struct Cancels<H, std::void_t<decltype(std::declval<const H&>().cancelled())>> : std::true_type {};
+
+struct ZeroHeuristic
+{
+    template<class G> void setGoal(const G&, int) {}
+    template<class N, class Dist, class G> Dist estimate(const G&, int) const { return Dist(0); }
+};
+
+struct ManhattanHeuristic
+{
+    int gx = 0, gy = 0;
+
+    template<class G> void setGoal(const G& grid, int goal)
+    {
+        gx = grid.x(goal);
+        gy = grid.y(goal);
+    }
+    template<class N, class Dist, class G> Dist estimate(const G& grid, int u) const
+    {
+        int ddx = std::abs(grid.x(u) - gx), ddy = std::abs(grid.y(u) - gy);
+        return Dist(ddx + ddy) * N::template straight<Dist>();
+    }
+};
+
+struct OctileHeuristic
+{
+    int gx = 0, gy = 0;
+
+    template<class G> void setGoal(const G& grid, int goal)
+    {
+        gx = grid.x(goal);
+        gy = grid.y(goal);
+    }
+    template<class N, class Dist, class G> Dist estimate(const G& grid, int u) const
+    {
+        int ddx = std::abs(grid.x(u) - gx), ddy = std::abs(grid.y(u) - gy);
+        int lo = std::min(ddx, ddy), hi = std::max(ddx, ddy);
+        return Dist(lo) * N::template diagonal<Dist>() + Dist(hi - lo) * N::template straight<Dist>();
+    }
+};
+
+// Differential heuristic max_L |d(L, goal) - d(L, u)| over exact distance
+// tables; the tables must come from the same neighborhood and Dist.
+template<class Dist>
+struct LandmarkHeuristic
+{
+    std::vector<int> cells;  // landmark slots, one per table
+    std::vector<std::vector<Dist>> tables;
+    std::vector<Dist> toGoal;
+
+    template<class G> void setGoal(const G&, int goal)
+    {
+        toGoal.resize(tables.size());
+        for (std::size_t l = 0; l < tables.size(); ++l)
+            toGoal[l] = tables[l][goal];
+    }
+    template<class N, class D, class G> D estimate(const G&, int u) const
+    {
+        Dist best = Dist(0);
+        for (std::size_t l = 0; l < tables.size(); ++l)
+        {
+            Dist a = tables[l][u], b = toGoal[l];
+            if (a == distInf<Dist>() || b == distInf<Dist>()) continue;
+            Dist d = a > b ? a - b : b - a;
+            if (d > best) best = d;
+        }
+        return D(best);
+    }
+};
+
+// Distance/predecessor storage. prev is a cell index, -1 at the start and
+// for unreached cells.
+template<class D>
+struct FullStorage
+{
+    using Dist = D;
+    std::vector<Dist> dist;
+    std::vector<int> prev;
+
+    void reset(int n)
+    {
+        dist.assign(n, distInf<Dist>());
+        prev.assign(n, -1);
+    }
+    Dist get(int u) const { return dist[u]; }
+    bool reached(int u) const { return dist[u] != distInf<Dist>(); }
+    void setStart(int u) { dist[u] = Dist(0); }
+    template<class N> void set(int v, Dist d, int u, int) { dist[v] = d; prev[v] = u; }
+    template<class G> int parent(const G&, int v) const { return prev[v]; }
+    std::size_t bytes() const { return dist.capacity() * sizeof(Dist) + prev.capacity() * sizeof(int); }
+};
+
+// Compact storage: narrow distances plus the move into each cell packed in
+// 2 bits (4-connected) or 4 bits (8-connected). parent() walks the move
+// backwards, so a path is rebuilt without a full prev index per cell.
+template<class D, class Neighborhood>
+struct CompactStorage
+{
+    using Dist = D;
+    static constexpr int BITS = Neighborhood::COUNT <= 4 ? 2 : 4;
+    static constexpr int PER_BYTE = 8 / BITS;
+    static constexpr std::uint8_t MASK = (1 << BITS) - 1;
+
+    std::vector<Dist> dist;
+    std::vector<std::uint8_t> dirs;
+    int start = -1;
+
+    void reset(int n)
+    {
+        dist.assign(n, distInf<Dist>());
+        dirs.assign((n + PER_BYTE - 1) / PER_BYTE, 0);
+        start = -1;
+    }
+    Dist get(int u) const { return dist[u]; }
+    bool reached(int u) const { return dist[u] != distInf<Dist>(); }
+    void setStart(int u)
+    {
+        dist[u] = Dist(0);
+        start = u;
+    }
+    template<class N> void set(int v, Dist d, int, int k)
+    {
+        static_assert(N::COUNT == Neighborhood::COUNT, "storage packs moves of its own neighborhood");
+        dist[v] = d;
+        int shift = (v % PER_BYTE) * BITS;
+        std::uint8_t& b = dirs[v / PER_BYTE];
+        b = std::uint8_t((b & ~(MASK << shift)) | (k << shift));
+    }
+    template<class G> int parent(const G& grid, int v) const
+    {
+        if (v == start || !reached(v)) return -1;
+        int k = (dirs[v / PER_BYTE] >> ((v % PER_BYTE) * BITS)) & MASK;
+        return grid.idx(grid.x(v) - Neighborhood::DX[k], grid.y(v) - Neighborhood::DY[k]);
+    }
+    std::size_t bytes() const { return dist.capacity() * sizeof(Dist) + dirs.capacity(); }
+};
+
+// Upper bound on any f = g + h on this grid with a geometric heuristic: g
+// never exceeds one step per free cell, h never exceeds width + height steps.
+// Used to pick the narrowest distance type that cannot overflow.
+template<class Neighborhood, class G>
+long long maxSearchKey(const G& grid)
+{
+    long long free = 0;
+    for (int c : grid.cells) free += c != 1;
+    long long step = std::max<long long>(Neighborhood::template straight<int>(),
+                                         Neighborhood::template diagonal<int>());
+    return (free + grid.width + grid.height) * step;
+}
@@ -1,30 +1,366 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <queue>
-#include <limits>
 #include <cstdlib>
 #include <ctime>
+#include <cstring>
 #include <algorithm>
 #include <iostream>
+#include <string>
+#include <chrono>
+#include "Grid.hpp"
+#include "Engines.hpp"
+#include "FrameStats.hpp"
+#include "Trace.hpp"
+#include "MapGen.hpp"
 
 static constexpr int GRID_SIZE = 40;
-static constexpr int INF = std::numeric_limits<int>::max();
-static constexpr int dx[4] = { 1, -1,  0,  0 };
-static constexpr int dy[4] = { 0,  0,  1, -1 };
 inline int idx(int x, int y) { return y * GRID_SIZE + x; }
 
 enum class State { Picking, Searching, Animating, Error };
 
-int main()
+static std::string formatStats(const SearchStats& s)
+{
+    return "popped " + std::to_string(s.popped) +
+        " (stale " + std::to_string(s.stale) + ")" +
+        "  pushed " + std::to_string(s.pushed) +
+        "  relaxed " + std::to_string(s.relaxed) +
+        "  peak open " + std::to_string(s.peakOpen) +
+        "  " + std::to_string(s.elapsedMs) + " ms";
+}
+
+struct HeadlessOptions
+{
+    int queries = 100;
+    int size = GRID_SIZE;
+    MapFamily family = MapFamily::Random;
+    Engine engine = Engine::Dijkstra;
+    bool compact = false;
+    bool goalBounds = false;
+    bool rsr = false;
+    bool smooth = false;
+    bool cache = false;
+    bool speculate = false;
+    std::string landmarks;
+    std::string tables;
+};
+
+// --headless [--queries N] [--size S] [--map random|maze|rooms|open] [--engine name] [--compact] [--goal-bounds]
+//            [--rsr] [--smooth] [--cache] [--speculate] [--landmarks file] [--tables file]
+static HeadlessOptions parseHeadless(int argc, char** argv)
+{
+    HeadlessOptions opt;
+    for (int a = 2; a < argc; ++a)
+    {
+        bool more = a + 1 < argc;
+        if (std::strcmp(argv[a], "--queries") == 0 && more) opt.queries = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--size") == 0 && more) opt.size = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--engine") == 0 && more) opt.engine = engineFromName(argv[++a], opt.engine);
+        else if (std::strcmp(argv[a], "--compact") == 0) opt.compact = true;
+        else if (std::strcmp(argv[a], "--goal-bounds") == 0) opt.goalBounds = true;
+        else if (std::strcmp(argv[a], "--rsr") == 0) opt.rsr = true;
+        else if (std::strcmp(argv[a], "--smooth") == 0) opt.smooth = true;
+        else if (std::strcmp(argv[a], "--cache") == 0) opt.cache = true;
+        else if (std::strcmp(argv[a], "--speculate") == 0) opt.speculate = true;
+        else if (std::strcmp(argv[a], "--landmarks") == 0 && more) opt.landmarks = argv[++a];
+        else if (std::strcmp(argv[a], "--tables") == 0 && more) opt.tables = argv[++a];
+        else if (std::strcmp(argv[a], "--map") == 0 && more)
+        {
+            ++a;
+            for (int f = 0; f < 4; ++f)
+                if (std::strcmp(argv[a], MAP_FAMILY_NAMES[f]) == 0) opt.family = MapFamily(f);
+        }
+    }
+    return opt;
+}
+
+// Loads prebuilt engine tables from file, or builds them and saves them there.
+template<class Load, class Build, class Save>
+static void loadOrBuild(const char* what, const std::string& file, Load load, Build build, Save save)
+{
+    if (!file.empty() && load())
+    {
+        std::cout << "loaded " << what << " from " << file << "\n";
+        return;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    build();
+    std::cout << "built " << what << " in "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() << " ms\n";
+    if (!file.empty() && save()) std::cout << "saved " << what << " to " << file << "\n";
+}
+
+// Random start/goal pairs on a generated map, no window.
+static int runHeadless(const HeadlessOptions& opt)
+{
+    MaskedGrid<Grid> grid(makeMap(opt.family, opt.size, unsigned(std::rand())));
+
+    PathFinder finder;
+    finder.engine = opt.engine;
+    finder.compact = opt.compact;
+    finder.cachePaths = opt.cache;
+    std::vector<int> path;
+    SearchStats stats, total;
+    int found = 0, q = 0;
+    std::cout << "engine " << ENGINE_NAMES[int(opt.engine)]
+              << (opt.compact ? " (compact storage)" : "") << "\n";
+
+    // ALT: reuse a table file written for this map, or build and save one.
+    // Expansions are reported against Manhattan A* on the same queries.
+    bool alt = opt.engine == Engine::Alt;
+    PathFinder baseline;
+    baseline.engine = Engine::AStar;
+    baseline.compact = opt.compact;
+    long long altExpanded = 0, baseExpanded = 0;
+    std::vector<int> corners, smoothed;
+    RunLengthPath runs;
+    std::size_t cellCount = 0, cornerCount = 0, smoothCount = 0, runBytes = 0;
+    if (alt)
+    {
+        if (!opt.landmarks.empty() && loadLandmarks(finder.landmarks, grid, opt.landmarks))
+        {
+            std::cout << "loaded " << finder.landmarks.cells.size() << " landmarks from " << opt.landmarks << "\n";
+        }
+        else
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            finder.landmarksFor<MaskedNeighborhood4>(grid);
+            std::cout << "selected " << finder.landmarks.cells.size() << " landmarks in "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                      << " ms\n";
+            if (!opt.landmarks.empty() && saveLandmarks(finder.landmarks, grid, opt.landmarks))
+                std::cout << "saved landmarks to " << opt.landmarks << "\n";
+        }
+    }
+
+    if (opt.goalBounds)
+    {
+        finder.goalBounding = true;
+        bool eight = opt.engine == Engine::AStar8 || opt.engine == Engine::Jps || opt.engine == Engine::JpsPlus;
+        auto t0 = std::chrono::steady_clock::now();
+        const GoalBounds& b = eight ? finder.boundsFor<MaskedNeighborhood8>(grid)
+                                    : finder.boundsFor<MaskedNeighborhood4>(grid);
+        std::cout << "built goal bounds in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                  << " ms, " << b.bytes() << " bytes\n";
+    }
+
+    if (opt.rsr)
+    {
+        finder.symmetryReduction = true;
+        auto t0 = std::chrono::steady_clock::now();
+        const EmptyRectangles& r = finder.rectanglesFor(grid);
+        std::cout << "split free space into " << r.count() << " rectangles ("
+                  << r.perimeterCells(grid) << " perimeter cells) in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                  << " ms\n";
+    }
+
+    // JPS+, CH and CPD: same load-or-build-and-save scheme for their tables.
+    if (opt.engine == Engine::JpsPlus)
+    {
+        loadOrBuild("jump table", opt.tables,
+                    [&] { return finder.jpsPlus.jumps.load(grid, opt.tables); },
+                    [&] { finder.jumpTableFor(grid); },
+                    [&] { return finder.jpsPlus.jumps.save(opt.tables); });
+        std::cout << finder.jpsPlus.jumps.bytes() << " bytes\n";
+    }
+    if (opt.engine == Engine::Ch)
+    {
+        loadOrBuild("hierarchy", opt.tables,
+                    [&] { return finder.hierarchy.load(grid, opt.tables); },
+                    [&] { finder.hierarchyFor<MaskedNeighborhood4>(grid); },
+                    [&] { return finder.hierarchy.save(opt.tables); });
+        std::cout << finder.hierarchy.nodes() << " nodes, " << finder.hierarchy.shortcuts() << " shortcuts, "
+                  << finder.hierarchy.bytes() << " bytes\n";
+    }
+    if (opt.engine == Engine::Cpd)
+    {
+        loadOrBuild("path database", opt.tables,
+                    [&] { return finder.database.load<MaskedNeighborhood4>(grid, opt.tables); },
+                    [&] { finder.databaseFor<MaskedNeighborhood4>(grid); },
+                    [&] { return finder.database.save(opt.tables); });
+        const auto& db = finder.database;
+        std::cout << db.nodes() << " sources, " << db.runCount() << " runs ("
+                  << (db.nodes() ? double(db.runCount()) / db.nodes() : 0.0) << " per source), "
+                  << db.bytes() << " bytes against " << (long long)db.nodes() * db.nodes() << " uncompressed\n";
+    }
+    if (opt.engine == Engine::Quadtree)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        const QuadTree& qt = finder.quadtreeFor(grid);
+        long long freeCells = 0;
+        for (int c : grid.cells) freeCells += c != 1;
+        std::cout << "built quadtree in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                  << " ms: " << qt.freeLeaves() << " free leaves (" << qt.leaves() << " in all) against "
+                  << freeCells << " free cells, " << qt.bytes() << " bytes\n";
+    }
+    if (opt.engine == Engine::NavMesh)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        const NavMesh& mesh = finder.navMeshFor(grid);
+        long long freeCells = 0;
+        for (int c : grid.cells) freeCells += c != 1;
+        std::cout << "built navmesh in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                  << " ms: " << mesh.polygons() << " polygons against " << freeCells << " free cells, "
+                  << mesh.bytes() << " bytes\n";
+    }
+    if (opt.engine == Engine::Subgoal)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        const SubgoalGraph& sg = finder.subgoalsFor<MaskedNeighborhood8>(grid);
+        std::cout << "built " << sg.subgoals() << " subgoals, " << sg.edgeTotal() << " edges in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count()
+                  << " ms, " << sg.bytes() << " bytes\n";
+    }
+
+    auto queries = makeQueries(grid, opt.queries, unsigned(std::rand()));
+    for (auto [s, g] : queries)
+    {
+        bool ok = finder.find(grid, s, g, path, stats);
+        found += ok;
+
+        std::cout << "query " << q++ << ": " << s << " -> " << g << "  "
+                  << (ok ? "cost " + std::to_string(finder.cost()) : std::string("no path"))
+                  << "  " << formatStats(stats);
+        if (alt)
+        {
+            SearchStats base;
+            std::vector<int> basePath;
+            baseline.find(grid, s, g, basePath, base);
+            altExpanded += stats.popped - stats.stale;
+            baseExpanded += base.popped - base.stale;
+            std::cout << "  astar expanded " << base.popped - base.stale;
+        }
+        std::cout << "\n";
+
+        // Path sizes: one int per cell against corners, string-pulled
+        // corners and run-length words.
+        if (opt.smooth && ok)
+        {
+            collapseCollinear(grid, path, corners);
+            smoothPath(grid, finder.lineOfSightFor(grid), path, smoothed);
+            encodeRuns(grid, path, runs);
+            cellCount += path.size();
+            cornerCount += corners.size();
+            smoothCount += smoothed.size();
+            runBytes += sizeof(runs.start) + runs.runs.size() * sizeof(runs.runs[0]);
+        }
+
+        total.popped += stats.popped;
+        total.stale += stats.stale;
+        total.pushed += stats.pushed;
+        total.relaxed += stats.relaxed;
+        total.peakOpen = std::max(total.peakOpen, stats.peakOpen);
+        total.elapsedMs += stats.elapsedMs;
+    }
+    std::cout << "total (" << found << "/" << opt.queries << " found): "
+              << formatStats(total) << "\n";
+    std::cout << "search storage " << finder.storageBytes() << " bytes\n";
+    // Cache: rounds of toggling a few cells away from the query ends, each
+    // followed by every query again; entries the edits could not affect are
+    // answered from cache. Every answer is checked against an uncached search
+    // kept up to date with the same edits, by cost where paths are optimal
+    // (quadtree paths are not, and a cached one may stay the longer).
+    if (opt.cache)
+    {
+        PathFinder fresh;
+        fresh.engine = opt.engine;
+        fresh.compact = opt.compact;
+        std::vector<int> freshPath;
+        SearchStats freshStats;
+        int wrong = 0;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int k = 0; k < 20; ++k)
+            {
+                int x = std::rand() % grid.width, y = std::rand() % grid.height, v = grid.idx(x, y);
+                bool end = false;
+                for (auto [s, g] : queries) end = end || s == v || g == v;
+                if (end) continue;
+                grid.set(x, y, grid[v] == 1 ? 0 : 1);
+                finder.cellChanged(grid, x, y);
+                fresh.cellChanged(grid, x, y);
+            }
+            for (auto [s, g] : queries)
+            {
+                bool ok = finder.find(grid, s, g, path, stats);
+                bool freshOk = fresh.find(grid, s, g, freshPath, freshStats);
+                bool optimal = opt.engine != Engine::Quadtree;
+                wrong += ok != freshOk || (ok && optimal && finder.cost() != fresh.cost());
+            }
+        }
+        const PathCacheStats& c = finder.cache.stats();
+        std::cout << "path cache: " << c.hits << " hits, " << c.misses << " misses, " << c.onPath
+                  << " dropped on path, " << c.inRegion << " dropped in search region, " << c.evicted << " evicted; "
+                  << finder.cache.size() << " entries, " << finder.cache.bytes() << " bytes; " << wrong
+                  << " answers differ from an uncached search\n";
+    }
+    // Speculation: flood from the first query's start, then send every
+    // query's goal from that start through the tree and, for comparison,
+    // through a plain search.
+    if (opt.speculate && !queries.empty())
+    {
+        int from = queries[0].first;
+        auto since = [](std::chrono::steady_clock::time_point t)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t).count();
+        };
+        finder.speculate = true;
+        auto t0 = std::chrono::steady_clock::now();
+        finder.prepare(grid, from);
+        finder.speculation.wait();
+        double flood = since(t0);
+        t0 = std::chrono::steady_clock::now();
+        for (auto [s, g] : queries) finder.find(grid, from, g, path, stats);
+        double fromTree = since(t0);
+        PathFinder plain;
+        plain.engine = opt.engine;
+        t0 = std::chrono::steady_clock::now();
+        for (auto [s, g] : queries) plain.find(grid, from, g, path, stats);
+        std::cout << "speculative tree from " << from << ": flooded in " << flood << " ms, " << queries.size()
+                  << " goals answered in " << fromTree << " ms against " << since(t0) << " ms searching\n";
+    }
+    if (opt.smooth)
+        std::cout << "paths: " << cellCount << " cells (" << cellCount * sizeof(int) << " bytes), " << cornerCount
+                  << " corners, " << smoothCount << " after smoothing, " << runBytes << " bytes run-length encoded\n";
+    if (alt)
+        std::cout << "expanded " << altExpanded << " vs " << baseExpanded << " for Manhattan A* ("
+                  << (baseExpanded ? 100.0 * altExpanded / baseExpanded : 0.0) << "%)\n";
+    return 0;
+}
+
+int main(int argc, char** argv)
 {
     std::srand(unsigned(std::time(nullptr)));
 
-    std::vector<int> grid(GRID_SIZE * GRID_SIZE, 0);
-    for (int i = 0, N = GRID_SIZE * GRID_SIZE / 3; i < N; ++i) {
-        int x = std::rand() % GRID_SIZE;
-        int y = std::rand() % GRID_SIZE;
-        grid[idx(x, y)] = 1;
+    if (argc > 1 && std::strcmp(argv[1], "--headless") == 0)
+        return runHeadless(parseHeadless(argc, argv));
+
+    // --trace [file]: record from launch; T toggles recording at runtime.
+    TraceRecorder trace;
+    std::string tracePath = "trace.json";
+    for (int a = 1; a < argc; ++a)
+    {
+        if (std::strcmp(argv[a], "--trace") == 0)
+        {
+            if (a + 1 < argc) tracePath = argv[++a];
+            trace.start();
+        }
     }
+    auto writeTrace = [&]()
+    {
+        trace.stop();
+        if (trace.write(tracePath))
+            std::cout << "Wrote " << trace.size() << " trace events to " << tracePath << "\n";
+        else
+            std::cerr << "Could not write " << tracePath << "\n";
+    };
+
+    Grid walls(GRID_SIZE, GRID_SIZE);
+    fillRandom(walls, GRID_SIZE * GRID_SIZE / 3);
+    MaskedGrid<Grid> grid(walls);
 
     sf::RenderWindow window(sf::VideoMode(
         { 800, 800 }), "Dijkstra Animated (SFML 3.0.0)", sf::Style::Default
@@ -74,12 +410,26 @@ int main()
 
     sf::Text fpsText{font, "", 12 };
     fpsText.setFillColor(sf::Color::White);
-    sf::Clock frameClock;
+    FrameStats frameStats;
+    sf::VertexArray frameGraph;
+    std::int64_t phaseBegin = trace.now();
+    auto endPhase = [&](Phase p)
+    {
+        frameStats.mark(p);
+        std::int64_t now = trace.now();
+        if (trace.enabled()) trace.record(PHASE_NAMES[int(p)], phaseBegin, now);
+        phaseBegin = now;
+    };
+    sf::Text statsText{font, "", 12 };
+    statsText.setFillColor(sf::Color::White);
+    SearchStats searchStats;
 
     State state;
     state = State::Picking;
     std::vector<sf::Vector2i> picks;  
-    std::vector<int> dist, prev, path;
+    PathFinder finder;
+    std::vector<int> path;
+    std::vector<Waypoint> route;
     int startIdx = 0, goalIdx = 0;
     int pathIdx = 0;
     sf::Clock animClock;
@@ -87,6 +437,7 @@ int main()
 
     while (window.isOpen())
     {
+        TraceScope frameScope(trace, "frame");
         while (auto ev = window.pollEvent())
         {
             if (ev->is<sf::Event::Closed>())
@@ -94,6 +445,64 @@ int main()
                 window.close(); break;
             }
 
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::T)
+            {
+                if (trace.enabled())
+                    writeTrace();
+                else
+                    trace.start();
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::E)
+            {
+                finder.engine = Engine((int(finder.engine) + 1) % ENGINE_COUNT);
+                std::cout << "Engine: " << ENGINE_NAMES[int(finder.engine)] << "\n";
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::C)
+            {
+                finder.compact = !finder.compact;
+                std::cout << "Compact storage: " << (finder.compact ? "on" : "off") << "\n";
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::G)
+            {
+                finder.goalBounding = !finder.goalBounding;
+                std::cout << "Goal bounding: " << (finder.goalBounding ? "on" : "off") << "\n";
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::R)
+            {
+                finder.symmetryReduction = !finder.symmetryReduction;
+                std::cout << "Symmetry reduction: " << (finder.symmetryReduction ? "on" : "off") << "\n";
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::S)
+            {
+                finder.smoothPaths = !finder.smoothPaths;
+                std::cout << "Path smoothing: " << (finder.smoothPaths ? "on" : "off") << "\n";
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::K)
+            {
+                finder.cachePaths = !finder.cachePaths;
+                std::cout << "Path cache: " << (finder.cachePaths ? "on" : "off") << "\n";
+            }
+
+            if (auto* kp = ev->getIf<sf::Event::KeyPressed>();
+                kp && kp->code == sf::Keyboard::Key::F)
+            {
+                finder.speculate = !finder.speculate;
+                std::cout << "Speculative flood: " << (finder.speculate ? "on" : "off") << "\n";
+            }
+
             if (auto* rs = ev->getIf<sf::Event::Resized>())
             {
                 float w = float(rs->size.x), h = float(rs->size.y);
@@ -122,13 +531,38 @@ int main()
                         int gx = std::clamp(int(world.x), 0, GRID_SIZE - 1);
                         int gy = std::clamp(int(world.y), 0, GRID_SIZE - 1);
                         picks.emplace_back(gx, gy);
-                        grid[idx(gx, gy)] = 0; 
+                        if (grid[idx(gx, gy)] == 1)
+                        {
+                            grid.set(gx, gy, 0);
+                            finder.cellChanged(grid, gx, gy);
+                        }
+                        if (picks.size() == 1)
+                            finder.prepare(grid, idx(gx, gy));
                         if (picks.size() == 2)
                             state = State::Searching;
                     }
                 }
             }
 
+            // A click while walking picks a new goal from the same start.
+            if (state == State::Animating)
+            {
+                if (auto* mb = ev->getIf<sf::Event::MouseButtonPressed>();
+                    mb && mb->button == sf::Mouse::Button::Left)
+                {
+                    sf::Vector2f world = window.mapPixelToCoords(sf::Mouse::getPosition(window), view);
+                    int gx = std::clamp(int(world.x), 0, GRID_SIZE - 1);
+                    int gy = std::clamp(int(world.y), 0, GRID_SIZE - 1);
+                    if (grid[idx(gx, gy)] == 1)
+                    {
+                        grid.set(gx, gy, 0);
+                        finder.cellChanged(grid, gx, gy);
+                    }
+                    picks[1] = sf::Vector2i(gx, gy);
+                    state = State::Searching;
+                }
+            }
+
             if (state == State::Error &&
                 (ev->is<sf::Event::MouseButtonPressed>() ||
                     ev->is<sf::Event::KeyPressed>()))
@@ -137,91 +571,51 @@ int main()
                 state = State::Picking;
             }
         }
+        endPhase(Phase::Events);
 
         if (state == State::Searching)
         {
-            int total = GRID_SIZE * GRID_SIZE;
-            dist.assign(total, INF);
-            prev.assign(total, -1);
-
+            TraceScope searchScope(trace, "search");
             startIdx = idx(picks[0].x, picks[0].y);
             goalIdx = idx(picks[1].x, picks[1].y);
-            dist[startIdx] = 0;
-
-            using Node = std::pair<int, int>;
-            auto cmp = [](auto& a, auto& b) { return a.first > b.first; };
-            std::priority_queue<Node, std::vector<Node>, decltype(cmp)> pq(cmp);
-            pq.push({ 0, startIdx });
-
-            while (!pq.empty())
-            {
-                auto [d, u] = pq.top(); pq.pop();
-                if (d > dist[u]) continue;
-                if (u == goalIdx) break;
-
-                int ux = u % GRID_SIZE, uy = u / GRID_SIZE;
-                for (int k = 0; k < 4; ++k)
-                {
-                    int vx = ux + dx[k], vy = uy + dy[k];
-                    if (vx < 0 || vy < 0 || vx >= GRID_SIZE || vy >= GRID_SIZE) continue;
-                    int v = idx(vx, vy);
-                    if (grid[v] == 1) continue;
-                    if (dist[v] > d + 1)
-                    {
-                        dist[v] = d + 1;
-                        prev[v] = u;
-                        pq.push({ dist[v], v });
-                    }
-                }
-            }
-
-            if (dist[goalIdx] == INF)
+            bool found = finder.find(grid, startIdx, goalIdx, path, searchStats);
+            statsText.setString(std::string(ENGINE_NAMES[int(finder.engine)]) + "  " +
+                                formatStats(searchStats) + "  storage " +
+                                std::to_string(finder.storageBytes()) + " B" +
+                                (finder.cachePaths ? "  cache " + std::to_string(finder.cache.stats().hits) + " hits / " +
+                                                         std::to_string(finder.cache.stats().misses) + " misses"
+                                                   : std::string()));
+
+            if (!found)
             {
                 std::cout << "No path! Click or press any key to retry.\n";
                 state = State::Error;
             }
             else
             {
-                path.clear();
-                for (int u = goalIdx; u != -1; u = prev[u])
-                    path.push_back(u);
-                std::reverse(path.begin(), path.end());
-
+                finder.waypoints(grid, path, route);
                 pathIdx = 0;
                 animClock.restart();
                 state = State::Animating;
             }
         }
+        endPhase(Phase::Search);
 
         if (state == State::Animating)
         {
-            float t = animClock.getElapsedTime().asSeconds() / SEGMENT_TIME;
-            if (t >= 1.f && pathIdx + 1 < (int)path.size())
-            {
-                pathIdx++;
-                animClock.restart();
-                t = 0.f;
-            }
-
-            int ci = path[pathIdx];
-            sf::Vector2f p0{ float(ci % GRID_SIZE) + 0.5f,
-                             float(ci / GRID_SIZE) + 0.5f };
-
-            if (pathIdx + 1 < (int)path.size())
-            {
-                int ni = path[pathIdx + 1];
-                sf::Vector2f p1{ float(ni % GRID_SIZE) + 0.5f,
-                                 float(ni / GRID_SIZE) + 0.5f };
-                character.setPosition(p0 + (p1 - p0) * std::min(t, 1.f));
-            }
-            else
-            {
-                character.setPosition(p0);
-            }
+            // Constant speed along the waypoints, one cell per SEGMENT_TIME;
+            // path cells are revealed in step with the distance covered.
+            float travelled = animClock.getElapsedTime().asSeconds() / SEGMENT_TIME;
+            float length = polylineLength(route);
+            int last = (int)path.size() - 1;
+            pathIdx = length > 0.f ? std::min(last, int(travelled / length * last)) : last;
+            Waypoint at = pointAlong(route, travelled);
+            character.setPosition(sf::Vector2f{ at.x, at.y });
 
             view.setCenter(character.getPosition());
             window.setView(view);
         }
+        endPhase(Phase::Animation);
 
         window.clear();
         window.setView(view);
@@ -273,6 +667,7 @@ int main()
                 }
             }
         }
+        endPhase(Phase::TileDraw);
 
         if (state == State::Animating)
             window.draw(character);
@@ -285,14 +680,27 @@ int main()
         }
 
         window.setView(window.getDefaultView());
-        float ft = frameClock.restart().asSeconds();
-        fpsText.setString("FPS: " + std::to_string(int(1.f / ft)));
+        fpsText.setString(frameStats.summary());
         fpsText.setPosition(sf::Vector2f{ 5, 5 });
         window.draw(fpsText);
+        if (state == State::Animating || state == State::Error)
+        {
+            statsText.setPosition(sf::Vector2f{ 5, 38 });
+            window.draw(statsText);
+        }
+        buildFrameGraph(frameStats, frameGraph,
+                        sf::Vector2f{ 5.f, window.getDefaultView().getSize().y - 5.f }, 2.f, 1.f);
+        window.draw(frameGraph);
+        endPhase(Phase::OverlayDraw);
 
         window.display();
+        endPhase(Phase::Display);
+        frameStats.commit();
     }
 
+    if (trace.enabled())
+        writeTrace();
+
     return 0;
 }
 
@@ -0,0 +1,158 @@
+#pragma once
+#include "Search.hpp"
+#include "NeighborMask.hpp"
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// Full shortest-path tree flooded from one start on a worker thread, so a
+// goal picked later is answered by walking predecessors instead of
+// searching, and so is every further goal from that start. The worker
+// floods a snapshot of the grid, so after an edit the tree is stale: tell
+// cellChanged(), or drop() it. Either one cancels a flood still running
+// rather than waiting for it to finish.
+class SpeculativeTree
+{
+public:
+    SpeculativeTree() = default;
+    SpeculativeTree(const SpeculativeTree&) = delete;
+    SpeculativeTree& operator=(const SpeculativeTree&) = delete;
+    ~SpeculativeTree() { drop(); }
+
+    // eight: flood with 8-connected moves, else 4-connected.
+    template<class G>
+    void start(const G& grid, int source, bool eight)
+    {
+        drop();
+        snapshot = MaskedGrid<Grid>(grid);
+        from = source;
+        diagonal = eight;
+        done = false;
+        worker = std::thread([this]
+        {
+            Cancellable flood{ {}, &cancel };
+            if (diagonal)
+                search<MaskedNeighborhood8, Cancellable, RadixHeapQueue<int>, FullStorage<int>, true>(
+                    snapshot, from, -1, store, stats, flood);
+            else
+                search<MaskedNeighborhood4, Cancellable, RadixHeapQueue<int>, FullStorage<int>, true>(
+                    snapshot, from, -1, store, stats, flood);
+            done = !cancel.load();
+        });
+    }
+
+    void drop()
+    {
+        cancel = true;
+        wait();
+        cancel = false;
+        from = -1;
+        opened = -1;
+    }
+
+    void wait()
+    {
+        if (worker.joinable()) worker.join();
+    }
+
+    // Call after cell toggled, with the grid already edited. The first cell
+    // opened since the flood, typically a goal picked on a wall, keeps the
+    // tree: nothing in it went through the cell, so the cell's own distance
+    // is its best neighbour's plus one step. Other goals may now be shorter
+    // through it, so covers() turns false and the next prepare() floods
+    // again. Any other edit floods again at once.
+    template<class G>
+    void cellChanged(const G& grid, int cell)
+    {
+        if (from < 0) return;
+        if (grid[cell] != 1 && opened < 0)
+        {
+            opened = cell;
+            openedValue = grid[cell];
+            openedCost = -1;
+            return;
+        }
+        start(grid, from, diagonal);
+    }
+
+    // A flood from source with those moves is running or finished, and no
+    // cell has opened since.
+    bool covers(int source, bool eight) const
+    {
+        return from >= 0 && from == source && diagonal == eight && opened < 0;
+    }
+    bool ready(int source, int goal, bool eight) const
+    {
+        return from >= 0 && from == source && diagonal == eight && (opened < 0 || goal == opened) && done.load();
+    }
+
+    // Only once ready(): the tree path to goal, false when it is unreachable.
+    bool pathTo(int goal, std::vector<int>& path)
+    {
+        wait();
+        if (goal != opened) return buildPath(snapshot, store, goal, path);
+        int via = openedParent();
+        path.clear();
+        if (via < 0) return false;
+        buildPath(snapshot, store, via, path);
+        path.push_back(goal);
+        return true;
+    }
+
+    long long cost(int goal) const
+    {
+        if (goal == opened) return openedCost;
+        return store.reached(goal) ? (long long)store.get(goal) : -1;
+    }
+    const SearchStats& floodStats() const { return stats; }
+    std::size_t bytes() const { return store.bytes(); }
+
+private:
+    // Flood heuristic that gives up once drop() raises the flag.
+    struct Cancellable : ZeroHeuristic
+    {
+        const std::atomic<bool>* flag;
+        bool cancelled() const { return flag->load(std::memory_order_relaxed); }
+    };
+
+    // The opened cell's best reached neighbour, its cost set in openedCost.
+    // Moves are symmetric, so each move out of the cell prices the step in.
+    int openedParent()
+    {
+        snapshot.set(snapshot.x(opened), snapshot.y(opened), openedValue);
+        int best = -1;
+        openedCost = -1;
+        auto consider = [&](int w, long long step)
+        {
+            if (!store.reached(w)) return;
+            long long d = (long long)store.get(w) + step;
+            if (best < 0 || d < openedCost)
+            {
+                best = w;
+                openedCost = d;
+            }
+        };
+        if (diagonal)
+            MaskedNeighborhood8::forEach(snapshot, opened, [&](int w, int k)
+            {
+                consider(w, MaskedNeighborhood8::cost<int>(k));
+            });
+        else
+            MaskedNeighborhood4::forEach(snapshot, opened, [&](int w, int k)
+            {
+                consider(w, MaskedNeighborhood4::cost<int>(k));
+            });
+        return best;
+    }
+
+    MaskedGrid<Grid> snapshot;
+    FullStorage<int> store;
+    SearchStats stats;
+    int from = -1;
+    bool diagonal = false;
+    int opened = -1, openedValue = 0;  // first cell opened since the flood
+    long long openedCost = -1;
+    std::atomic<bool> done{ false };
+    std::atomic<bool> cancel{ false };
+    std::thread worker;
+};
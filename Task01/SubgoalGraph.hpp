@@ -0,0 +1,345 @@
+#pragma once
+#include "Search.hpp"
+#include "Parallel.hpp"
+#include <vector>
+#include <atomic>
+#include <cstdlib>
+#include <algorithm>
+
+// Simple subgoal graph. Subgoals sit at convex corners: free cells with a wall
+// diagonally next to them and both cells beside that wall free. Two subgoals
+// share an edge when one is direct-h-reachable from the other: some path as
+// short as their octile distance (Manhattan for 4-connected moves) joins them
+// without passing another subgoal. A query joins start and goal to the
+// subgoals they reach directly, runs A* over the small graph and refines each
+// edge back into cells.
+//
+// update() patches the graph after a cell toggles: only subgoals around the
+// cell, subgoals with an edge across it and subgoals that reach it directly
+// are re-explored.
+class SubgoalGraph
+{
+public:
+    int threads = hardwareThreads();
+
+    template<class Neighborhood, class G>
+    void build(const G& grid)
+    {
+        moves = Neighborhood::COUNT;
+        width = grid.width;
+        height = grid.height;
+        idOf.assign(grid.size(), -1);
+        cells.clear();
+        edges.clear();
+        freeIds.clear();
+        for (int v = 0; v < grid.size(); ++v)
+            if (isCorner(grid, v)) addSubgoal(v);
+
+        std::vector<Scratch> scratch(std::max(1, threads));
+        std::atomic<int> next{ 0 };
+        runThreads(std::max(1, std::min<int>(threads, int(cells.size()))), [&](int t)
+        {
+            for (int id; (id = next.fetch_add(1)) < int(cells.size());)
+                explore<Neighborhood>(grid, cells[id], -1, scratch[t], edges[id]);
+        });
+        edgeCount = 0;
+        for (const auto& e : edges) edgeCount += e.size();
+    }
+
+    // Call after cell (cx, cy) changed, with the grid already edited.
+    template<class Neighborhood, class G>
+    void update(const G& grid, int cx, int cy)
+    {
+        if (empty() || moves != Neighborhood::COUNT) return;
+        int x0 = std::max(0, cx - 1), x1 = std::min(width - 1, cx + 1);
+        int y0 = std::max(0, cy - 1), y1 = std::min(height - 1, cy + 1);
+        std::vector<char> dirty(cells.size(), 0);
+        std::vector<int> redo;
+        auto mark = [&](int id)
+        {
+            if (id >= int(dirty.size())) dirty.resize(id + 1, 0);
+            if (!dirty[id]) redo.push_back(id);
+            dirty[id] = 1;
+        };
+
+        // Edges whose refined path may cross the change.
+        for (int a = 0; a < int(cells.size()); ++a)
+            for (int b : edges[a])
+            {
+                int ax = grid.x(cells[a]), ay = grid.y(cells[a]), bx = grid.x(cells[b]), by = grid.y(cells[b]);
+                if (std::max(ax, bx) >= x0 && std::min(ax, bx) <= x1 && std::max(ay, by) >= y0 && std::min(ay, by) <= y1)
+                {
+                    mark(a);
+                    mark(b);
+                }
+            }
+
+        // Subgoals that come and go with the change.
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+            {
+                int v = grid.idx(x, y);
+                bool corner = isCorner(grid, v);
+                if (corner && idOf[v] < 0) mark(addSubgoal(v));
+                else if (!corner && idOf[v] >= 0) removeSubgoal(idOf[v]);
+            }
+
+        // New edges pass through the change, so their ends reach it directly.
+        Scratch s;
+        std::vector<int> found;
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x)
+            {
+                int v = grid.idx(x, y);
+                if (grid[v] == 1) continue;
+                if (idOf[v] >= 0) mark(idOf[v]);
+                found.clear();
+                explore<Neighborhood>(grid, v, -1, s, found);
+                for (int id : found) mark(id);
+            }
+
+        for (int a : redo)
+        {
+            if (cells[a] < 0) continue;
+            for (int b : edges[a])
+                if (!dirty[b]) edges[b].erase(std::find(edges[b].begin(), edges[b].end(), a));
+            edges[a].clear();
+        }
+        for (int a : redo)
+        {
+            if (cells[a] < 0) continue;
+            explore<Neighborhood>(grid, cells[a], -1, s, edges[a]);
+            for (int b : edges[a])
+                if (!dirty[b]) edges[b].push_back(a);
+        }
+        edgeCount = 0;
+        for (const auto& e : edges) edgeCount += e.size();
+    }
+
+    // Cell path from startIdx to goalIdx; stats count the subgoals expanded.
+    template<class Neighborhood, bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        path.clear();
+        lastCost = -1;
+        if (grid[startIdx] == 1 || grid[goalIdx] == 1) { rec.finish(); return false; }
+
+        found.clear();
+        if (explore<Neighborhood>(grid, startIdx, goalIdx, scratch, found) || startIdx == goalIdx)
+        {
+            path.push_back(startIdx);
+            refine<Neighborhood>(grid, startIdx, goalIdx, path);
+            lastCost = distance<Neighborhood>(grid, startIdx, goalIdx);
+            rec.finish();
+            return true;
+        }
+
+        // Node ids: subgoals, then start and goal.
+        int n = int(cells.size()), S = n, T = n + 1;
+        dist.assign(n + 2, INF);
+        parent.assign(n + 2, -1);
+        toGoal.assign(n, 0);
+        std::vector<int> fromStart = found;
+        found.clear();
+        explore<Neighborhood>(grid, goalIdx, -1, scratch, found);
+        for (int id : found) toGoal[id] = 1;
+
+        auto cellOf = [&](int id) { return id == S ? startIdx : id == T ? goalIdx : cells[id]; };
+        auto h = [&](int id) { return distance<Neighborhood>(grid, cellOf(id), goalIdx); };
+        RadixHeapQueue<int> pq;
+        pq.reset(n + 2);
+        dist[S] = 0;
+        pq.push(h(S), S);
+        rec.push(pq.size());
+        auto relax = [&](int u, int v)
+        {
+            int nd = dist[u] + distance<Neighborhood>(grid, cellOf(u), cellOf(v));
+            if (nd >= dist[v]) return;
+            dist[v] = nd;
+            parent[v] = u;
+            rec.relax();
+            pq.push(nd + h(v), v);
+            rec.push(pq.size());
+        };
+        while (!pq.empty())
+        {
+            auto [f, u] = pq.pop();
+            rec.pop();
+            if (f > dist[u] + h(u)) { rec.stale(); continue; }
+            if (u == T) break;
+            if (u == S)
+            {
+                for (int v : fromStart) relax(u, v);
+                continue;
+            }
+            for (int v : edges[u]) relax(u, v);
+            if (toGoal[u]) relax(u, T);
+        }
+        rec.finish();
+        if (dist[T] == INF) return false;
+
+        std::vector<int> route;
+        for (int id = T; id >= 0; id = parent[id]) route.push_back(cellOf(id));
+        std::reverse(route.begin(), route.end());
+        path.push_back(startIdx);
+        for (std::size_t i = 1; i < route.size(); ++i) refine<Neighborhood>(grid, route[i - 1], route[i], path);
+        lastCost = dist[T];
+        return true;
+    }
+
+    long long cost() const { return lastCost; }
+    int subgoals() const { return int(cells.size() - freeIds.size()); }
+    std::size_t edgeTotal() const { return edgeCount; }
+    bool empty() const { return idOf.empty(); }
+    bool matches(int w, int h) const { return width == w && height == h; }
+
+    std::size_t bytes() const
+    {
+        std::size_t b = (idOf.capacity() + cells.capacity() + freeIds.capacity() + dist.capacity() +
+                         parent.capacity() + found.capacity() + scratch.stamp.capacity() + scratch.prev.capacity() +
+                         scratch.queue.capacity()) * sizeof(int) + toGoal.capacity();
+        for (const auto& e : edges) b += e.capacity() * sizeof(int);
+        return b;
+    }
+
+private:
+    struct Scratch
+    {
+        std::vector<int> stamp, prev, queue;
+        int epoch = 0;
+
+        void begin(int size)
+        {
+            if (int(stamp.size()) != size)
+            {
+                stamp.assign(size, 0);
+                prev.assign(size, -1);
+                epoch = 0;
+            }
+            ++epoch;
+            queue.clear();
+        }
+    };
+
+    template<class G>
+    static bool isFree(const G& grid, int x, int y)
+    {
+        return grid.inside(x, y) && grid[grid.idx(x, y)] != 1;
+    }
+
+    template<class G>
+    static bool isCorner(const G& grid, int v)
+    {
+        if (grid[v] == 1) return false;
+        int x = grid.x(v), y = grid.y(v);
+        for (int dy : { -1, 1 })
+            for (int dx : { -1, 1 })
+                if (grid.inside(x + dx, y + dy) && !isFree(grid, x + dx, y + dy) &&
+                    isFree(grid, x + dx, y) && isFree(grid, x, y + dy))
+                    return true;
+        return false;
+    }
+
+    // Octile distance in the neighborhood's units; Neighborhood4 prices a
+    // diagonal at two straights, which makes it Manhattan.
+    template<class N, class G>
+    static int distance(const G& grid, int a, int b)
+    {
+        int dx = std::abs(grid.x(a) - grid.x(b)), dy = std::abs(grid.y(a) - grid.y(b));
+        int lo = std::min(dx, dy), hi = std::max(dx, dy);
+        return lo * N::template diagonal<int>() + (hi - lo) * N::template straight<int>();
+    }
+
+    int addSubgoal(int v)
+    {
+        int id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+            cells[id] = v;
+        }
+        else
+        {
+            id = int(cells.size());
+            cells.push_back(v);
+            edges.emplace_back();
+        }
+        idOf[v] = id;
+        return id;
+    }
+
+    void removeSubgoal(int id)
+    {
+        for (int b : edges[id]) edges[b].erase(std::find(edges[b].begin(), edges[b].end(), id));
+        edges[id].clear();
+        idOf[cells[id]] = -1;
+        cells[id] = -1;
+        freeIds.push_back(id);
+    }
+
+    // Every cell reachable from src by moves that each add exactly their cost
+    // to the distance from src, stopping at subgoals (appended to found).
+    // Returns whether target was reached on the way.
+    template<class N, class G>
+    bool explore(const G& grid, int src, int target, Scratch& s, std::vector<int>& found) const
+    {
+        s.begin(grid.size());
+        s.stamp[src] = s.epoch;
+        s.queue.push_back(src);
+        bool reached = false;
+        for (std::size_t i = 0; i < s.queue.size(); ++i)
+        {
+            int u = s.queue[i], du = distance<N>(grid, src, u);
+            N::forEach(grid, u, [&](int v, int k)
+            {
+                if (s.stamp[v] == s.epoch || distance<N>(grid, src, v) != du + N::template cost<int>(grid, v, k)) return;
+                s.stamp[v] = s.epoch;
+                if (v == target) reached = true;
+                if (idOf[v] >= 0) found.push_back(idOf[v]);
+                else s.queue.push_back(v);
+            });
+        }
+        return reached;
+    }
+
+    // Appends the cells after a up to b along a path of length distance(a, b).
+    template<class N, class G>
+    void refine(const G& grid, int a, int b, std::vector<int>& path)
+    {
+        Scratch& s = scratch;
+        s.begin(grid.size());
+        s.stamp[a] = s.epoch;
+        s.queue.push_back(a);
+        int total = distance<N>(grid, a, b);
+        for (std::size_t i = 0; i < s.queue.size() && s.stamp[b] != s.epoch; ++i)
+        {
+            int u = s.queue[i], du = distance<N>(grid, a, u);
+            N::forEach(grid, u, [&](int v, int k)
+            {
+                int dv = du + N::template cost<int>(grid, v, k);
+                if (s.stamp[v] == s.epoch || distance<N>(grid, a, v) != dv || dv + distance<N>(grid, v, b) != total)
+                    return;
+                s.stamp[v] = s.epoch;
+                s.prev[v] = u;
+                s.queue.push_back(v);
+            });
+        }
+        std::size_t from = path.size();
+        for (int v = b; v != a; v = s.prev[v]) path.push_back(v);
+        std::reverse(path.begin() + from, path.end());
+    }
+
+    int moves = 0, width = 0, height = 0;
+    std::size_t edgeCount = 0;
+    std::vector<int> idOf;                 // subgoal id per slot, -1 elsewhere
+    std::vector<int> cells;                // slot per id, -1 once removed
+    std::vector<int> freeIds;
+    std::vector<std::vector<int>> edges;   // direct-h-reachable subgoal ids
+
+    Scratch scratch;
+    std::vector<int> dist, parent, found;
+    std::vector<char> toGoal;
+    long long lastCost = -1;
+};
@@ -0,0 +1,146 @@
+#pragma once
+#include "Search.hpp"
+#include "LineOfSight.hpp"
+#include "Waypoints.hpp"
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Lazy Theta*: A* over the 8-connected grid in Euclidean distances, except
+// that a cell hands each neighbour its own parent, so paths bend only at wall
+// corners and come out as a few long segments rather than one per cell. The
+// line of sight behind that shortcut is only checked once the neighbour is
+// expanded, one check per expansion instead of one per edge. Not always the
+// shortest any-angle path (Anya is exact), but never longer than the octile
+// one.
+//
+// update() patches the line-of-sight bits after a cell toggles.
+class ThetaStar
+{
+public:
+    template<class G>
+    void build(const G& grid) { sight.load(grid); }
+
+    template<class G>
+    void update(const G& grid, int cx, int cy)
+    {
+        if (!empty()) sight.set(cx, cy, grid[grid.idx(cx, cy)] == 1);
+    }
+
+    // Neighborhood is the 8-connected policy for G; stats.relaxed counts
+    // line-of-sight checks.
+    template<class Neighborhood, bool Instrument = false, class G>
+    bool find(const G& grid, int startIdx, int goalIdx, std::vector<int>& path, SearchStats& stats)
+    {
+        StatsRecorder<Instrument> rec(stats);
+        path.clear();
+        line.clear();
+        lastCost = -1;
+        if (grid[startIdx] == 1 || grid[goalIdx] == 1) { rec.finish(); return false; }
+
+        if (int(dist.size()) != grid.size())
+        {
+            dist.assign(grid.size(), INFINITY);
+            parent.assign(grid.size(), -1);
+            closed.assign(grid.size(), 0);
+            touched.clear();
+        }
+        for (int v : touched)
+        {
+            dist[v] = INFINITY;
+            closed[v] = 0;
+        }
+        touched.clear();
+
+        Waypoint goal = cellCentre(grid, goalIdx);
+        auto h = [&](int v) { return distance(cellCentre(grid, v), goal); };
+        auto step = [&](int a, int b) { return distance(cellCentre(grid, a), cellCentre(grid, b)); };
+        BinaryHeapQueue<float> pq;
+        dist[startIdx] = 0.f;
+        parent[startIdx] = startIdx;
+        touched.push_back(startIdx);
+        pq.push(h(startIdx), startIdx);
+        rec.push(pq.size());
+        while (!pq.empty())
+        {
+            auto [f, u] = pq.pop();
+            rec.pop();
+            if (closed[u] || f > dist[u] + h(u)) { rec.stale(); continue; }
+            closed[u] = 1;
+
+            // Lazy: u was handed its parent unchecked. If the parent cannot
+            // see u after all, fall back to the best expanded neighbour.
+            int p = parent[u];
+            rec.relax();
+            if (p != u && !sight.clear(grid.x(p), grid.y(p), grid.x(u), grid.y(u)))
+            {
+                dist[u] = INFINITY;
+                Neighborhood::forEach(grid, u, [&](int w, int)
+                {
+                    if (!closed[w] || w == u) return;
+                    float nd = dist[w] + step(w, u);
+                    if (nd < dist[u])
+                    {
+                        dist[u] = nd;
+                        parent[u] = w;
+                    }
+                });
+                p = parent[u];
+            }
+            if (u == goalIdx) break;
+
+            Neighborhood::forEach(grid, u, [&](int v, int)
+            {
+                if (closed[v]) return;
+                float nd = dist[p] + step(p, v);
+                if (nd >= dist[v]) return;
+                if (dist[v] == INFINITY) touched.push_back(v);
+                dist[v] = nd;
+                parent[v] = p;
+                pq.push(nd + h(v), v);
+                rec.push(pq.size());
+            });
+        }
+        rec.finish();
+        if (dist[goalIdx] == INFINITY) return false;
+
+        route.clear();
+        for (int v = goalIdx;; v = parent[v])
+        {
+            route.push_back(v);
+            if (v == startIdx) break;
+        }
+        std::reverse(route.begin(), route.end());
+        path.push_back(startIdx);
+        for (std::size_t i = 0; i < route.size(); ++i)
+        {
+            line.push_back(cellCentre(grid, route[i]));
+            if (i > 0) appendSegmentCells(grid, route[i - 1], route[i], path);
+        }
+        lastCost = std::lround(dist[goalIdx] * 10.f);
+        return true;
+    }
+
+    // Corners of the last path, start and goal cell centres included.
+    const std::vector<Waypoint>& polyline() const { return line; }
+
+    long long cost() const { return lastCost; }  // path length in tenths of a cell
+    bool empty() const { return sight.empty(); }
+    bool matches(int w, int h) const { return sight.matches(w, h); }
+    const LineOfSight& lineOfSight() const { return sight; }
+
+    std::size_t bytes() const
+    {
+        return sight.bytes() + dist.capacity() * sizeof(float) + closed.capacity() +
+               (parent.capacity() + touched.capacity() + route.capacity()) * sizeof(int) +
+               line.capacity() * sizeof(Waypoint);
+    }
+
+private:
+    LineOfSight sight;
+    std::vector<float> dist;
+    std::vector<char> closed;
+    std::vector<int> parent, touched, route;  // route: corner cells of the last path
+    std::vector<Waypoint> line;
+    long long lastCost = -1;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+// Chrome trace-event recorder (chrome://tracing, ui.perfetto.dev). Events go
+// into a preallocated buffer and are only formatted when the trace is written,
+// so a running trace costs two clock reads and a store per scope.
+class TraceRecorder
+{
+public:
+    explicit TraceRecorder(std::size_t capacity = 1 << 18)
+        : origin(Clock::now())
+    {
+        events.reserve(capacity);
+    }
+
+    bool enabled() const { return recording; }
+
+    void start()
+    {
+        events.clear();
+        dropped = 0;
+        recording = true;
+    }
+
+    void stop() { recording = false; }
+
+    std::int64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - origin).count();
+    }
+
+    void record(const char* name, std::int64_t begin, std::int64_t end)
+    {
+        if (events.size() == events.capacity()) { ++dropped; return; }
+        events.push_back({ name, begin, end - begin });
+    }
+
+    bool write(const std::string& file) const
+    {
+        std::ofstream out(file);
+        if (!out) return false;
+        out << "{\"traceEvents\":[\n";
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            const Event& e = events[i];
+            out << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+                << e.ts << ",\"dur\":" << e.dur << "}" << (i + 1 < events.size() ? ",\n" : "\n");
+        }
+        out << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":" << dropped << "}}\n";
+        return bool(out);
+    }
+
+    std::size_t size() const { return events.size(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        const char* name;   // string literal, never copied
+        std::int64_t ts, dur;
+    };
+
+    std::vector<Event> events;
+    std::size_t dropped = 0;
+    bool recording = false;
+    Clock::time_point origin;
+};
+
+class TraceScope
+{
+public:
+    TraceScope(TraceRecorder& trace, const char* name)
+        : trace(trace), name(name), active(trace.enabled()), begin(active ? trace.now() : 0) {}
+
+    ~TraceScope()
+    {
+        if (active && trace.enabled()) trace.record(name, begin, trace.now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceRecorder& trace;
+    const char* name;
+    bool active;
+    std::int64_t begin;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <cmath>
+
+// A point in cell units: cell (x, y) covers [x, x + 1) x [y, y + 1), so its
+// centre is (x + 0.5, y + 0.5).
+struct Waypoint
+{
+    float x, y;
+};
+
+inline float distance(const Waypoint& a, const Waypoint& b)
+{
+    return std::hypot(b.x - a.x, b.y - a.y);
+}
+
+template<class G>
+Waypoint cellCentre(const G& grid, int cell)
+{
+    return Waypoint{ float(grid.x(cell)) + 0.5f, float(grid.y(cell)) + 0.5f };
+}
+
+// Centre of every cell on a cell path.
+template<class G>
+void cellWaypoints(const G& grid, const std::vector<int>& path, std::vector<Waypoint>& out)
+{
+    out.clear();
+    for (int c : path) out.push_back(cellCentre(grid, c));
+}
+
+inline float polylineLength(const std::vector<Waypoint>& points)
+{
+    float len = 0.f;
+    for (std::size_t i = 1; i < points.size(); ++i) len += distance(points[i - 1], points[i]);
+    return len;
+}
+
+// The point s along the polyline, clamped to its ends.
+inline Waypoint pointAlong(const std::vector<Waypoint>& points, float s)
+{
+    if (points.empty()) return Waypoint{ 0.f, 0.f };
+    for (std::size_t i = 1; i < points.size(); ++i)
+    {
+        float len = distance(points[i - 1], points[i]);
+        if (s <= len && len > 0.f)
+        {
+            float t = s / len;
+            return Waypoint{ points[i - 1].x + (points[i].x - points[i - 1].x) * t,
+                             points[i - 1].y + (points[i].y - points[i - 1].y) * t };
+        }
+        s -= len;
+    }
+    return points.back();
+}
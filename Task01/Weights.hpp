@@ -0,0 +1,56 @@
+#pragma once
+#include "Grid.hpp"
+#include "SearchPolicies.hpp"
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <algorithm>
+
+// Grid plus a per-slot entry cost (1..255). Walls keep their weight but are
+// never entered. Weights start at 1, which matches the unweighted engines.
+template<class G>
+struct WeightedGrid : G
+{
+    std::vector<std::uint8_t> weights;
+
+    WeightedGrid() = default;
+    explicit WeightedGrid(const G& grid) : G(grid), weights(std::size_t(grid.size()), 1) {}
+
+    int maxWeight() const { return weights.empty() ? 1 : *std::max_element(weights.begin(), weights.end()); }
+};
+
+// Move k into v costs Base's cost of k times the weight of v. Geometric
+// heuristics stay admissible because no weight is below 1.
+template<class Base>
+struct WeightedNeighborhood : Base
+{
+    template<class Dist, class G> static constexpr Dist cost(const G& grid, int v, int k)
+    {
+        return Base::template cost<Dist>(k) * Dist(grid.weights[v]);
+    }
+};
+
+using WeightedNeighborhood4 = WeightedNeighborhood<Neighborhood4>;
+using WeightedNeighborhood8 = WeightedNeighborhood<Neighborhood8>;
+
+// Smooth terrain: a coarse random lattice of weights in [1, maxWeight],
+// bilinearly interpolated so costs form hills and valleys.
+template<class G>
+void fillTerrain(WeightedGrid<G>& grid, int maxWeight, unsigned seed, int scale = 16)
+{
+    std::mt19937 rng(seed);
+    int lw = grid.width / scale + 2, lh = grid.height / scale + 2;
+    std::vector<float> lattice(std::size_t(lw) * lh);
+    for (float& v : lattice) v = float(rng() % unsigned(maxWeight));
+
+    for (int y = 0; y < grid.height; ++y)
+        for (int x = 0; x < grid.width; ++x)
+        {
+            int cx = x / scale, cy = y / scale;
+            float fx = float(x % scale) / scale, fy = float(y % scale) / scale;
+            auto at = [&](int i, int j) { return lattice[std::size_t(j) * lw + i]; };
+            float top = at(cx, cy) * (1 - fx) + at(cx + 1, cy) * fx;
+            float bottom = at(cx, cy + 1) * (1 - fx) + at(cx + 1, cy + 1) * fx;
+            grid.weights[grid.idx(x, y)] = std::uint8_t(1 + int(top * (1 - fy) + bottom * fy + 0.5f));
+        }
+}